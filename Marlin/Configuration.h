@@ -141,6 +141,11 @@
 //#define MACHINE_UUID "00000000-0000-0000-0000-000000000000"
 
 //#define DWIN_RENDER_THUMBNAIL  // Enable the Rendering of the Thumbnail Image from Gcode Script for E3V3SE
+#if ENABLED(DWIN_RENDER_THUMBNAIL)
+  #define DWIN_THUMB_SLICE_MS 8   // (ms) Max time per idle() call spent drawing the preview. M1010 reports the worst case.
+  #define DWIN_THUMB_INDEX_SIZE 8 // Files whose thumbnail offset and metadata are remembered to skip re-scanning
+  //#define DWIN_THUMB_HEATSHRINK  // Also draw heatshrink-compressed E3V3SE_THUMB_HS thumbnails (orca_parser.py --heatshrink)
+#endif
 
 
 // |                |
@@ -2578,6 +2583,17 @@
 #if ENABLED(EEPROM_SETTINGS)
   #define EEPROM_AUTO_INIT  // Init EEPROM automatically on any errors.
   //#define EEPROM_INIT_NOW   // Init EEPROM on first boot after a new build.
+
+  /**
+   * Save to alternating halves of an I2C EEPROM (IIC_BL24CXX_EEPROM) in the background.
+   * M500 returns at once and idle() writes the changed pages, so saves don't stall a print.
+   * A power loss during the write leaves the previous settings intact.
+   * Ignored with other EEPROM types and on other platforms.
+   */
+  #define EEPROM_ASYNC_COMMIT
+  #if ENABLED(EEPROM_ASYNC_COMMIT)
+    //#define EEPROM_COMMIT_BUDGET_US 1000  // Time per idle() call spent writing
+  #endif
 #endif
 
 // @section host
@@ -3652,6 +3668,10 @@
 
 //
 #define DWIN_CREALITY_LCD
+#if ENABLED(DWIN_CREALITY_LCD)
+  #define DWIN_TX_QUEUE_SIZE 1024 // (bytes) Power of 2. Draw commands queue here and drain in the background. M1010 reports the high-water mark.
+  #define DWIN_LCD_BYTES_PER_SEC 4000 // (bytes) Once this much has gone to the LCD within a second, changed status values wait for the next second. 0 for no limit.
+#endif
 
 
 //
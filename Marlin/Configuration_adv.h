@@ -1020,6 +1020,20 @@
     #define BLTOUCH_HS_EXTRA_CLEARANCE    7 // Extra Z Clearance
   #endif
 
+  /**
+   * Fast G29 mesh (bilinear) for HIGH SPEED mode. The pin stays deployed for the whole mesh.
+   * Each XY travel starts with the Z raise and runs with it as one move along the serpentine path,
+   * and each point is probed once at the fast rate. The slow second probe only runs when the result
+   * misses the height predicted from the points probed before it. Preheating overlaps the travel to
+   * the first point. Only 'G29 K1' uses it, so a plain G29 (and the LCD) keeps MULTIPLE_PROBING.
+   * G29 reports its time either way, for comparing the two.
+   */
+  #define BLTOUCH_FAST_MESH
+  #if ENABLED(BLTOUCH_FAST_MESH)
+    #define BLTOUCH_FAST_MESH_TOLERANCE 0.05 // (mm) Probe again slowly when further than this from the prediction
+    #define BLTOUCH_FAST_MESH_LIFT      1    // (mm) Straight lift off each point before the travel starts
+  #endif
+
 #endif // BLTOUCH
 
 // @section calibrate
@@ -1438,6 +1452,15 @@
  */
 #define ADAPTIVE_STEP_SMOOTHING
 
+/**
+ * Stepper ISR Profile
+ * Count CPU cycles (DWT CYCCNT) spent in each phase of the Stepper ISR: min/avg/max and a histogram,
+ * late ISRs, and how often multi-stepping and step smoothing kick in. Use to find the highest step
+ * rate before the ISR saturates the MCU. Report with 'M1011', reset with 'M1011 R'.
+ * Requires an ARM Cortex-M3/M4/M7. Adds a few dozen cycles to each ISR.
+ */
+//#define STEPPER_ISR_PROFILE
+
 /**
  * Custom Microstepping
  * Override as-needed for your setup. Up to 3 MS pins are supported.
@@ -1775,6 +1798,37 @@
 
   #define SD_PROCEDURE_DEPTH 1              // Increase if you need more nested M32 calls
 
+  /**
+   * SDIO Read-Ahead
+   * With ONBOARD_SDIO, sequential reads are streamed with CMD18 multi-block reads
+   * into a double buffer in the background, so a print rarely waits on the card.
+   * Uses 2 x SDIO_READ_AHEAD_BLOCKS x 512 bytes of RAM. M1014 reports throughput.
+   */
+  #define SDIO_READ_AHEAD
+  #if ENABLED(SDIO_READ_AHEAD)
+    #define SDIO_READ_AHEAD_BLOCKS 4        // Blocks per buffer half (2-16)
+  #endif
+
+  #define SD_FAT_CACHE                      // Cache FAT blocks apart from file data and directory entries (+512 bytes RAM)
+  #define SD_EXTENT_MAP                     // Map the cluster runs of the file being printed, so reads and seeks skip the FAT
+  #if ENABLED(SD_EXTENT_MAP)
+    #define SD_EXTENT_MAP_SIZE 8            // Runs to map. Past the last one the FAT chain is followed as usual.
+  #endif
+
+  /**
+   * Directory Index
+   * Note where each visible item of the working directory starts when the folder
+   * or media changes, and keep a window of names around the last one selected.
+   * Drawing and scrolling the file list then reads no more than one window of
+   * directory entries at a time instead of rescanning the folder for each row.
+   * Uses 2 bytes per indexed item and (15 + LONG_FILENAME_LENGTH) bytes per name.
+   */
+  #define SD_DIR_INDEX
+  #if ENABLED(SD_DIR_INDEX)
+    #define SD_DIR_INDEX_SIZE  512          // Items indexed per folder. Items after these are found by scanning.
+    #define SD_DIR_INDEX_NAMES  16          // Names kept around the selected item
+  #endif
+
   #define SD_FINISHED_STEPPERRELEASE true   // Disable steppers when SD Print is finished
   #define SD_FINISHED_RELEASECOMMAND "G1 X0 Y215\nM84"  // Use "M84XYE" to keep Z enabled so your bed stays in place
 
@@ -1806,7 +1860,7 @@
    * an option on the LCD screen to continue the print from the last-known
    * point in the file.
    */
-  //#define POWER_LOSS_RECOVERY
+  #define POWER_LOSS_RECOVERY
   #if ENABLED(POWER_LOSS_RECOVERY)
     #define PLR_ENABLED_DEFAULT       true // Power-Loss Recovery enabled by default. (Set with 'M413 Sn' & M500)
     //#define PLR_BED_THRESHOLD BED_MAXTEMP // (°C) Skip user confirmation at or above this bed temperature (0 to disable)
@@ -1833,6 +1887,20 @@
     #if ENABLED(POWER_LOSS_RECOVER_ZHOME)
       //#define POWER_LOSS_ZHOME_POS { 0, 0 } // Safe XY position to home Z while avoiding objects on the bed
     #endif
+
+    /**
+     * Journal the recovery data instead of rewriting the recovery file.
+     * The file is made once per print as a contiguous, erased run of blocks.
+     * Saves then write one block directly, with no FAT or directory updates:
+     * a small record (position, temperatures, fans...) added to a ring, or
+     * the full state when other settings changed. The newest valid entry is
+     * found at boot by its sequence number and CRC.
+     */
+    #define POWER_LOSS_JOURNAL
+    #if ENABLED(POWER_LOSS_JOURNAL)
+      #define POWER_LOSS_JOURNAL_BLOCKS   32 // (blocks) File size in 512-byte blocks, including 2 for the full state
+      #define POWER_LOSS_JOURNAL_MS    10000 // (ms) Also save between layers this often while printing. Set to 0 to disable.
+    #endif
   #endif
 
   /**
@@ -1969,11 +2037,26 @@
   //#define CONFIGURATION_EMBEDDING
 
   // Add an optimized binary file transfer mode, initiated with 'M28 B1'
+  // Not compatible with MeatPack. Disable MEATPACK_ON_SERIAL_PORT_1 to use it.
   //#define BINARY_FILE_TRANSFER
 
   #if ENABLED(BINARY_FILE_TRANSFER)
     // Include extra facilities (e.g., 'M20 F') supporting firmware upload via BINARY_FILE_TRANSFER
     //#define CUSTOM_FIRMWARE_UPLOAD
+
+    /**
+     * Streaming uploads (protocol 0.2, see buildroot/share/scripts/MarlinBinaryProtocol.py)
+     *  - The host keeps BINARY_STREAM_WINDOW packets in flight instead of waiting for each 'ok'.
+     *  - A file sent with its size is written to a contiguous run of clusters with a
+     *    multi-block write, through the SDIO_READ_AHEAD buffers on SDIO boards.
+     *  - The effective transfer rate is reported when the file is closed.
+     * The window takes BINARY_STREAM_WINDOW * BINARY_STREAM_PACKET_SIZE bytes of SRAM.
+     */
+    #define BINARY_STREAM_UPLOAD
+    #if ENABLED(BINARY_STREAM_UPLOAD)
+      #define BINARY_STREAM_WINDOW          4 // (packets) Received ahead of the SD writes
+      #define BINARY_STREAM_PACKET_SIZE   512 // (bytes) Largest packet payload
+    #endif
   #endif
 
   // "Over-the-air" Firmware Update with M936 - Required to set EEPROM flag
@@ -2386,6 +2469,7 @@
   #define BETWEEN_Z       6                            // Safe distance from brush or automatic Z offset to tool sensing area
   #define AUTOTOOL_RESULT                           // debug CRTouch probe info
   #define AUTOTOOL_PRINT
+  #define AUTOZ_PROBE_BY_MOVE                       // Probe the pressure sensor with one continuous Z move instead of 0.02mm steps
 #endif
 
 // @section extruder
@@ -2727,6 +2811,16 @@
   #define BLOCK_BUFFER_SIZE 32
 #endif
 
+/**
+ * Planner Starvation Profile
+ * Record how full the planner stays while printing, and each time the stepper
+ * runs out of blocks mid-print: when, the file position, the length and speed
+ * of the last segment, and how long the stepper sat idle. Shows which files or
+ * host connections starve the motion system. Report with 'M1013', reset with
+ * 'M1013 R'. A summary is shown on the DWIN print-complete screen.
+ */
+//#define PLANNER_STARVATION_PROFILE
+
 // @section serial
 
 // The ASCII buffer for serial input
@@ -2774,6 +2868,12 @@
 // Not supported on all platforms.
 //#define RX_BUFFER_MONITOR
 
+// Serial link health statistics for each port: lines/s, bytes/s, resends, line number
+// and checksum errors, RX buffer high-water mark and overruns, and the time the command
+// queue ran empty while printing. Tells a poor host link apart from planner starvation.
+// M1012 reports, M1012 S<seconds> auto-reports, M1012 R resets.
+//#define SERIAL_LINK_STATS
+
 /**
  * Emergency Command Parser
  *
@@ -4086,6 +4186,7 @@
 
 /**
  * Support for MeatPack G-code compression (https://github.com/scottmudge/OctoPrint-MeatPack)
+ * Not compatible with BINARY_FILE_TRANSFER.
  */
 #define MEATPACK_ON_SERIAL_PORT_1
 //#define MEATPACK_ON_SERIAL_PORT_2
@@ -4757,6 +4858,9 @@
 // Enable Tests that will run at startup and produce a report
 //#define MARLIN_TEST_BUILD
 
+// Planner hooks for the host-side motion pipeline benchmark (linux_native_test only)
+//#define MOTION_BENCHMARK
+
 // Enable Marlin dev mode which adds some special commands
 //#define MARLIN_DEV_MODE
 
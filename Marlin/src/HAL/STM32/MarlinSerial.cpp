@@ -120,6 +120,10 @@ void MarlinSerial::begin(unsigned long baud, uint8_t config) {
         obj->rx_buff[obj->rx_head] = c;
         obj->rx_head = i;
       }
+      #if ENABLED(SERIAL_LINK_STATS)
+        else
+          rx_dropped_bytes++;
+      #endif
 
       #if ENABLED(EMERGENCY_PARSER)
         emergency_parser.update(static_cast<MSerialT*>(this)->emergency_state, c);
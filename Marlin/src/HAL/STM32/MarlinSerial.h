@@ -70,6 +70,11 @@
     void _rx_complete_irq(serial_t *obj);
     FORCE_INLINE static uint8_t buffer_overruns() { return 0; } // Not implemented. Void to avoid platform-dependent code.
 
+    #if ENABLED(SERIAL_LINK_STATS)
+      volatile uint32_t rx_dropped_bytes = 0;                   // Bytes lost to a full RX buffer
+      uint32_t dropped() const { return rx_dropped_bytes; }
+    #endif
+
     protected:
       usart_rx_callback_t _rx_callback;
   };
@@ -35,50 +35,140 @@
 
 #include "../../shared/eeprom_if.h"
 #include "../../shared/eeprom_api.h"
+#include "../../../libs/BL24CXX.h"
+#include "../../../libs/BL24CXX_page.h"
+
+#define DEBUG_OUT ENABLED(EEPROM_CHITCHAT)
+#include "../../../core/debug_out.h"
 
 //
 // PersistentStore
 //
+// The whole EEPROM is read into RAM on first access. Writes go to the copy and
+// only the pages that changed are sent, one page per transfer.
+//
 
 #ifndef MARLIN_EEPROM_SIZE
   #error "MARLIN_EEPROM_SIZE is required for IIC_BL24CXX_EEPROM."
 #endif
 
-size_t PersistentStore::capacity()    { return MARLIN_EEPROM_SIZE - eeprom_exclude_size; }
-
-bool PersistentStore::access_start()  { eeprom_init(); return true; }
-bool PersistentStore::access_finish() { return true; }
-
-bool PersistentStore::write_data(int &pos, const uint8_t *value, size_t size, uint16_t *crc) {
-  uint16_t written = 0;
-  while (size--) {
-    uint8_t v = *value;
-    uint8_t * const p = (uint8_t * const)REAL_EEPROM_ADDR(pos);
-    if (v != eeprom_read_byte(p)) { // EEPROM has only ~100,000 write cycles, so only write bytes that have changed!
-      eeprom_write_byte(p, v);
-      if (++written & 0x7F) delay(2); else safe_delay(2); // Avoid triggering watchdog during long EEPROM writes
-      if (eeprom_read_byte(p) != v) {
-        SERIAL_ECHO_MSG(STR_ERR_EEPROM_WRITE);
-        return true;
-      }
+#if ENABLED(EEPROM_ASYNC_COMMIT)
+
+  // Two copies of the store, one in each half of the chip, committed from idle()
+  typedef EEPROMSlots<BL24CXX, MARLIN_EEPROM_SIZE> eeprom_slots_t;
+  static eeprom_slots_t eeprom_slots;
+
+  #ifndef EEPROM_COMMIT_BUDGET_US
+    #define EEPROM_COMMIT_BUDGET_US 1000
+  #endif
+
+  static bool image_written;    // write_data was called since access_start
+
+  // One bus operation of the running commit. Return 'false' when there's nothing left to do.
+  static bool commit_step() {
+    switch (eeprom_slots.step()) {
+      case eeprom_slots_t::Shadow::FLUSH_BUSY: return true;
+      case eeprom_slots_t::Shadow::FLUSH_ERROR: SERIAL_ECHO_MSG(STR_ERR_EEPROM_WRITE); break;  // The newer half is still intact
+      case eeprom_slots_t::Shadow::FLUSH_DONE: DEBUG_ECHOLNPGM("EEPROM slot ", eeprom_slots.active_slot, " committed, seq ", eeprom_slots.active_seq); break;
+    }
+    return false;
+  }
+
+  bool PersistentStore::committing() { return eeprom_slots.committing(); }
+
+  void PersistentStore::commit_task() {
+    if (!eeprom_slots.committing()) return;
+    const uint32_t start = micros();
+    while (commit_step() && micros() - start < EEPROM_COMMIT_BUDGET_US) { /* nada */ }
+  }
+
+  size_t PersistentStore::capacity()    { return eeprom_slots.slot_size - eeprom_exclude_size; }
+
+  bool PersistentStore::access_start() {
+    image_written = false;
+    if (eeprom_slots.is_loaded()) return true;
+    eeprom_init();
+    if (!eeprom_slots.load()) return false;
+    DEBUG_ECHOLNPGM("EEPROM slot ", eeprom_slots.active_slot, " seq ", eeprom_slots.active_seq);
+    return true;
+  }
+
+  bool PersistentStore::access_finish() {
+    if (image_written) eeprom_slots.commit();
+    return true;
+  }
+
+  bool PersistentStore::write_data(int &pos, const uint8_t *value, size_t size, uint16_t *crc) {
+    image_written = true;
+    while (size--) {
+      const uint8_t v = *value;
+      eeprom_slots.image[REAL_EEPROM_ADDR(pos)] = v;
+      crc16(crc, &v, 1);
+      pos++;
+      value++;
     }
-    crc16(crc, &v, 1);
-    pos++;
-    value++;
+    return false;
   }
-  return false;
-}
-
-bool PersistentStore::read_data(int &pos, uint8_t *value, size_t size, uint16_t *crc, const bool writing/*=true*/) {
-  do {
-    const uint8_t c = eeprom_read_byte((uint8_t*)REAL_EEPROM_ADDR(pos));
-    if (writing) *value = c;
-    crc16(crc, &c, 1);
-    pos++;
-    value++;
-  } while (--size);
-  return false;
-}
+
+  bool PersistentStore::read_data(int &pos, uint8_t *value, size_t size, uint16_t *crc, const bool writing/*=true*/) {
+    do {
+      const uint8_t c = eeprom_slots.image[REAL_EEPROM_ADDR(pos)];
+      if (writing) *value = c;
+      crc16(crc, &c, 1);
+      pos++;
+      value++;
+    } while (--size);
+    return false;
+  }
+
+#else // !EEPROM_ASYNC_COMMIT
+
+  static EEPROMShadow<BL24CXX, MARLIN_EEPROM_SIZE> eeprom_shadow;
+
+  size_t PersistentStore::capacity()    { return MARLIN_EEPROM_SIZE - eeprom_exclude_size; }
+
+  bool PersistentStore::access_start() {
+    if (eeprom_shadow.is_loaded()) return true;
+    eeprom_init();
+    return eeprom_shadow.load();
+  }
+
+  bool PersistentStore::access_finish() {
+    if (!eeprom_shadow.pending()) return true;
+    const uint16_t before = eeprom_shadow.pages_written;
+    const bool err = eeprom_shadow.flush();
+    DEBUG_ECHOLNPGM("EEPROM pages written: ", eeprom_shadow.pages_written - before);
+    UNUSED(before);
+    if (err) {
+      SERIAL_ECHO_MSG(STR_ERR_EEPROM_WRITE);
+      return false;
+    }
+    return true;
+  }
+
+  bool PersistentStore::write_data(int &pos, const uint8_t *value, size_t size, uint16_t *crc) {
+    while (size--) {
+      const uint8_t v = *value;
+      eeprom_shadow.write(REAL_EEPROM_ADDR(pos), v);
+      crc16(crc, &v, 1);
+      pos++;
+      value++;
+    }
+    return false;
+  }
+
+  bool PersistentStore::read_data(int &pos, uint8_t *value, size_t size, uint16_t *crc, const bool writing/*=true*/) {
+    do {
+      const uint8_t c = eeprom_shadow.read(REAL_EEPROM_ADDR(pos));
+      if (writing) *value = c;
+      crc16(crc, &c, 1);
+      pos++;
+      value++;
+    } while (--size);
+    return false;
+  }
+
+#endif // !EEPROM_ASYNC_COMMIT
 
 #endif // IIC_BL24CXX_EEPROM
 #endif // HAL_STM32
@@ -406,6 +406,163 @@ bool SDIO_ReadBlock(uint32_t block, uint8_t *dst) {
   #endif
 }
 
+#if ENABLED(SDIO_READ_AHEAD)
+
+  static bool stream_active = false, stream_write, stream_landed;
+  static millis_t stream_timeout;
+
+  #if defined(__DCACHE_PRESENT) && __DCACHE_PRESENT
+    // On Cortex-M7 (F7, H7) DMA goes around the data cache. Clean the buffer before
+    // the DMA reads it, and clean it before / invalidate it after the DMA fills it.
+    static uint8_t *stream_buf;
+    static int32_t stream_len;
+    #define DCACHE_CLEAN(A,N)       SCB_CleanDCache_by_Addr((uint32_t*)(A), N)
+    #define DCACHE_CLEAN_INV(A,N)   SCB_CleanInvalidateDCache_by_Addr((uint32_t*)(A), N)
+    #define DCACHE_INVALIDATE(A,N)  SCB_InvalidateDCache_by_Addr((uint32_t*)(A), N)
+  #else
+    #define DCACHE_CLEAN(A,N)       NOOP
+    #define DCACHE_CLEAN_INV(A,N)   NOOP
+    #define DCACHE_INVALIDATE(A,N)  NOOP
+  #endif
+
+  // Track a transfer that was started, or clean up after one that failed to start
+  static bool stream_begin(const HAL_StatusTypeDef ret, const bool write) {
+    if (ret != HAL_OK) {
+      #ifdef SDIO_FOR_STM32H7
+        waitingRxCplt = waitingTxCplt = 0;
+      #else
+        HAL_DMA_Abort_IT(&hdma_sdio);
+        HAL_DMA_DeInit(&hdma_sdio);
+      #endif
+      return false;
+    }
+    stream_active = true;
+    stream_write = write;
+    stream_landed = false;
+    stream_timeout = millis() + SD_TIMEOUT;
+    return true;
+  }
+
+  /**
+   * @brief Start a multi-block read
+   * @details Issue CMD18 and let DMA fill the buffer in the background.
+   *          No other transfer may start until SDIO_Blocks_Poll() reports it done.
+   *
+   * @param block The first block index
+   * @param dst The buffer for count blocks, aligned to a cache line (32 bytes)
+   * @param count The number of blocks
+   *
+   * @return true if the transfer was started
+   */
+  bool SDIO_ReadBlocks_Start(uint32_t block, uint8_t *dst, uint16_t count) {
+    if (stream_active || HAL_SD_GetCardState(&hsd) != HAL_SD_CARD_TRANSFER) return false;
+
+    // No dirty line may be written back over the DMA data
+    DCACHE_CLEAN_INV(dst, count * 512);
+    #if defined(__DCACHE_PRESENT) && __DCACHE_PRESENT
+      stream_buf = dst;
+      stream_len = count * 512;
+    #endif
+
+    #ifdef SDIO_FOR_STM32H7
+      waitingRxCplt = 1;
+    #else
+      hdma_sdio.Init.Direction = DMA_PERIPH_TO_MEMORY;
+      HAL_DMA_Init(&hdma_sdio);
+    #endif
+
+    return stream_begin(HAL_SD_ReadBlocks_DMA(&hsd, dst, block, count), false);
+  }
+
+  /**
+   * @brief Start a multi-block write
+   * @details Issue CMD25 and let DMA feed the card from the buffer in the background.
+   *          No other transfer may start until SDIO_Blocks_Poll() reports it done.
+   *
+   * @param block The first block index
+   * @param src The data for count blocks, word aligned
+   * @param count The number of blocks
+   *
+   * @return true if the transfer was started
+   */
+  bool SDIO_WriteBlocks_Start(uint32_t block, const uint8_t *src, uint16_t count) {
+    if (stream_active || HAL_SD_GetCardState(&hsd) != HAL_SD_CARD_TRANSFER) return false;
+
+    DCACHE_CLEAN(src, count * 512);
+
+    #ifdef SDIO_FOR_STM32H7
+      waitingTxCplt = 1;
+    #else
+      hdma_sdio.Init.Direction = DMA_MEMORY_TO_PERIPH;
+      HAL_DMA_Init(&hdma_sdio);
+    #endif
+
+    return stream_begin(HAL_SD_WriteBlocks_DMA(&hsd, (uint8_t*)src, block, count), true);
+  }
+
+  /**
+   * @brief Check on a multi-block transfer
+   * @details Finish the transfer once the card is done, or abort it on timeout.
+   *          After a write the card stays busy programming, so that is waited
+   *          out here too rather than by the next transfer.
+   *
+   * @return 1 when done (or idle), 0 while busy, -1 on failure
+   */
+  int8_t SDIO_Blocks_Poll() {
+    if (!stream_active) return 1;
+
+    if (!stream_landed) {
+      #ifdef SDIO_FOR_STM32H7
+        const bool busy = stream_write ? waitingTxCplt : waitingRxCplt;
+      #else
+        const bool busy = hsd.State != HAL_SD_STATE_READY;
+      #endif
+
+      if (busy) {
+        if (PENDING(millis(), stream_timeout)) return 0;
+        HAL_SD_Abort(&hsd);  // Send CMD12 so the card leaves the data state
+        #ifdef SDIO_FOR_STM32H7
+          waitingRxCplt = waitingTxCplt = 0;
+        #else
+          HAL_DMA_Abort_IT(&hdma_sdio);
+          HAL_DMA_DeInit(&hdma_sdio);
+        #endif
+        stream_active = false;
+        return -1;
+      }
+
+      #ifndef SDIO_FOR_STM32H7
+        while (__HAL_DMA_GET_FLAG(&hdma_sdio, __HAL_DMA_GET_TC_FLAG_INDEX(&hdma_sdio)) != 0
+            || __HAL_DMA_GET_FLAG(&hdma_sdio, __HAL_DMA_GET_TE_FLAG_INDEX(&hdma_sdio)) != 0) { /* nada */ }
+
+        HAL_DMA_Abort_IT(&hdma_sdio);
+        HAL_DMA_DeInit(&hdma_sdio);
+      #endif
+
+      if (hsd.ErrorCode != HAL_SD_ERROR_NONE) {
+        stream_active = false;
+        return -1;
+      }
+
+      // Drop any line the CPU fetched while the DMA was filling the buffer
+      if (!stream_write) DCACHE_INVALIDATE(stream_buf, stream_len);
+
+      stream_landed = true;
+      stream_timeout = millis() + SD_TIMEOUT;
+    }
+
+    if (HAL_SD_GetCardState(&hsd) != HAL_SD_CARD_TRANSFER) {
+      if (PENDING(millis(), stream_timeout)) return 0;
+      stream_active = false;
+      return -1;
+    }
+
+    stream_active = false;
+    return 1;
+  }
+
+#endif // SDIO_READ_AHEAD
+
 /**
  * @brief Write a block
  * @details Write a block to media with SDIO
@@ -51,6 +51,12 @@ public:
   // Housecleaning after read or write
   static bool access_finish();
 
+  #if ENABLED(EEPROM_ASYNC_COMMIT)
+    // Write the last saved data to storage in the background, from idle()
+    static void commit_task();
+    static bool committing();
+  #endif
+
   // Write one or more bytes of data and update the CRC
   // Return 'true' on write error
   static bool write_data(int &pos, const uint8_t *value, size_t size, uint16_t *crc);
@@ -790,6 +790,9 @@ void idle(const bool no_stepper_sleep/*=false*/) {
   // Max7219 heartbeat, animation, etc
   TERN_(MAX7219_DEBUG, max7219.idle_tasks());
 
+  // Write saved settings to the EEPROM a page at a time
+  TERN_(EEPROM_ASYNC_COMMIT, persistentStore.commit_task());
+
   // Return if setup() isn't completed
   if (marlin_state == MarlinState::MF_INITIALIZING) goto IDLE_DONE;
 
@@ -860,6 +863,7 @@ void idle(const bool no_stepper_sleep/*=false*/) {
       TERN_(AUTO_REPORT_SD_STATUS, card.auto_reporter.tick());
       TERN_(AUTO_REPORT_POSITION, position_auto_reporter.tick());
       TERN_(BUFFER_MONITORING, queue.auto_report_buffer_statistics());
+      TERN_(SERIAL_LINK_STATS, queue.auto_report_link_stats());
     }
   #endif
 
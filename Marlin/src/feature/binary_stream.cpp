@@ -31,6 +31,20 @@ char* SDFileTransferProtocol::Packet::Open::data = nullptr;
 size_t SDFileTransferProtocol::data_waiting, SDFileTransferProtocol::transfer_timeout, SDFileTransferProtocol::idle_timeout;
 bool SDFileTransferProtocol::transfer_active, SDFileTransferProtocol::dummy_transfer, SDFileTransferProtocol::compression;
 
+#if ENABLED(BINARY_STREAM_COMPRESSION)
+  uint8_t SDFileTransferProtocol::decode_buffer[512] __attribute__((aligned(sizeof(size_t))));
+  heatshrink_decoder SDFileTransferProtocol::hsd;
+#endif
+
+#if ENABLED(BINARY_STREAM_UPLOAD)
+  uint32_t SDFileTransferProtocol::Packet::Open::size;
+  decltype(SDFileTransferProtocol::stats) SDFileTransferProtocol::stats;
+
+  // One window, shared by all ports since only one can be transferring
+  BinaryStream::Slot BinaryStream::window[BINARY_STREAM_WINDOW];
+  uint8_t BinaryStream::window_head, BinaryStream::window_count;
+#endif
+
 BinaryStream binaryStream[NUM_SERIAL];
 
 #endif
@@ -26,9 +26,6 @@
 #define BINARY_STREAM_COMPRESSION
 #if ENABLED(BINARY_STREAM_COMPRESSION)
   #include "../libs/heatshrink/heatshrink_decoder.h"
-  // STM32 (and others?) require a word-aligned buffer for SD card transfers via DMA
-  static __attribute__((aligned(sizeof(size_t)))) uint8_t decode_buffer[512] = {};
-  static heatshrink_decoder hsd;
 #endif
 
 inline bool bs_serial_data_available(const serial_index_t index) {
@@ -43,35 +40,81 @@ class SDFileTransferProtocol  {
 private:
   struct Packet {
     struct [[gnu::packed]] Open {
+      // The filename may be followed by the 32-bit file size (version 0.2)
       static bool validate(char *buffer, size_t length) {
-        return (length > sizeof(Open) && buffer[length - 1] == '\0');
+        if (length <= sizeof(Open)) return false;
+        const char * const end = (const char*)memchr(&buffer[2], '\0', length - 2);
+        if (!end) return false;
+        const size_t tail = &buffer[length - 1] - end;
+        return tail == 0 || TERN0(BINARY_STREAM_UPLOAD, tail == 4);
       }
-      static Open& decode(char *buffer) {
+      static Open& decode(char *buffer, size_t length) {
         data = &buffer[2];
+        size = 0;
+        const size_t name_end = strlen(data) + 3;
+        if (length == name_end + 4) memcpy(&size, &buffer[name_end], 4);
         return *reinterpret_cast<Open*>(buffer);
       }
       bool compression_enabled() { return compression & 0x1; }
       bool dummy_transfer() { return dummy & 0x1; }
       static char* filename() { return data; }
+      static uint32_t file_size() { return size; }
       private:
         uint8_t dummy, compression;
         static char* data;  // variable length strings complicate things
+        static uint32_t size;
     };
   };
 
-  static bool file_open(char *filename) {
+  static bool file_open(char *filename, const uint32_t size) {
     if (!dummy_transfer) {
       card.mount();
       card.openFileWrite(filename);
       if (!card.isFileOpen()) return false;
+      TERN(BINARY_STREAM_UPLOAD, if (size) card.uploadStart(size), UNUSED(size));
     }
     transfer_active = true;
     data_waiting = 0;
     TERN_(BINARY_STREAM_COMPRESSION, heatshrink_decoder_reset(&hsd));
+    #if ENABLED(BINARY_STREAM_UPLOAD)
+      stats.start_ms = millis();
+      stats.file_bytes = stats.wire_bytes = 0;
+    #endif
     return true;
   }
 
+  #if ENABLED(BINARY_STREAM_UPLOAD)
+
+    // Gather uncompressed data into whole blocks too, for the multi-block write
+    static bool block_write(const char *buffer, size_t length) {
+      while (length) {
+        const size_t n = _MIN(length, sizeof(decode_buffer) - data_waiting);
+        memcpy(&decode_buffer[data_waiting], buffer, n);
+        data_waiting += n;
+        buffer += n;
+        length -= n;
+        if (data_waiting == sizeof(decode_buffer)) {
+          if (!dummy_transfer && card.write(decode_buffer, data_waiting) < 0) return false;
+          stats.file_bytes += data_waiting;
+          data_waiting = 0;
+        }
+      }
+      return true;
+    }
+
+    // Report the effective transfer rate, with the bytes sent over the wire when compressed
+    static void report_rate() {
+      const millis_t ms = _MAX(millis() - stats.start_ms, 1UL);
+      SERIAL_ECHO_START();
+      SERIAL_ECHO(F("Upload "), stats.file_bytes, F(" bytes"));
+      if (compression) SERIAL_ECHO(F(" ("), stats.wire_bytes, F(" sent)"));
+      SERIAL_ECHOLN(F(" in "), ms, F("ms, "), uint32_t(uint64_t(stats.file_bytes) * 1000 / ms), F(" B/s"));
+    }
+
+  #endif
+
   static bool file_write(char *buffer, const size_t length) {
+    TERN_(BINARY_STREAM_UPLOAD, stats.wire_bytes += length);
     #if ENABLED(BINARY_STREAM_COMPRESSION)
       if (compression) {
         size_t total_processed = 0, processed_count = 0;
@@ -88,6 +131,7 @@ private:
                 if (card.write(decode_buffer, data_waiting) < 0) {
                   return false;
                 }
+              TERN_(BINARY_STREAM_UPLOAD, stats.file_bytes += data_waiting);
               data_waiting = 0;
             }
           } while (presult == HSDR_POLL_MORE);
@@ -95,7 +139,11 @@ private:
         return true;
       }
     #endif
-    return (dummy_transfer || card.write(buffer, length) >= 0);
+    #if ENABLED(BINARY_STREAM_UPLOAD)
+      return block_write(buffer, length);
+    #else
+      return (dummy_transfer || card.write(buffer, length) >= 0);
+    #endif
   }
 
   static bool file_close() {
@@ -104,13 +152,16 @@ private:
         // flush any buffered data
         if (data_waiting) {
           if (card.write(decode_buffer, data_waiting) < 0) return false;
+          TERN_(BINARY_STREAM_UPLOAD, stats.file_bytes += data_waiting);
           data_waiting = 0;
         }
       #endif
+      if (!TERN1(BINARY_STREAM_UPLOAD, card.uploadFinish())) return false;
       card.closefile();
       card.release();
     }
     TERN_(BINARY_STREAM_COMPRESSION, heatshrink_decoder_finish(&hsd));
+    TERN_(BINARY_STREAM_UPLOAD, report_rate());
     transfer_active = false;
     return true;
   }
@@ -130,6 +181,14 @@ private:
 
   static size_t data_waiting, transfer_timeout, idle_timeout;
   static bool transfer_active, dummy_transfer, compression;
+  #if ENABLED(BINARY_STREAM_COMPRESSION)
+    // STM32 (and others?) require a word-aligned buffer for SD card transfers via DMA
+    static uint8_t decode_buffer[512] __attribute__((aligned(sizeof(size_t))));
+    static heatshrink_decoder hsd;
+  #endif
+  #if ENABLED(BINARY_STREAM_UPLOAD)
+    static struct { millis_t start_ms; uint32_t file_bytes, wire_bytes; } stats;
+  #endif
 
 public:
 
@@ -158,10 +217,10 @@ public:
           SERIAL_ECHOLNPGM("PFT:busy");
         else {
           if (Packet::Open::validate(buffer, length)) {
-            auto packet = Packet::Open::decode(buffer);
+            auto packet = Packet::Open::decode(buffer, length);
             compression = packet.compression_enabled();
             dummy_transfer = packet.dummy_transfer();
-            if (file_open(packet.filename())) {
+            if (file_open(packet.filename(), packet.file_size())) {
               SERIAL_ECHOLNPGM("PFT:success");
               break;
             }
@@ -194,7 +253,7 @@ public:
     }
   }
 
-  static const uint16_t version_major = 0, version_minor = 1, version_patch = 0, timeout = 10000, idle_period = 1000;
+  static const uint16_t version_major = 0, version_minor = TERN(BINARY_STREAM_UPLOAD, 2, 1), version_patch = 0, timeout = 10000, idle_period = 1000;
 };
 
 class BinaryStream {
@@ -254,8 +313,33 @@ public:
     sync = 0;
     packet_retries = 0;
     buffer_next_index = 0;
+    TERN_(BINARY_STREAM_UPLOAD, window_count = 0);
   }
 
+  #if ENABLED(BINARY_STREAM_UPLOAD)
+    /**
+     * The host may send up to window_size packets ahead of the last 'ok'.
+     * Each is held in a slot until it can be processed without waiting on the
+     * media, and is acknowledged as its slot is freed, so acks double as flow
+     * control. A lost or corrupt packet gets 'rs' and everything after it is
+     * dropped until the host goes back and resends from there.
+     */
+    struct Slot { Packet::Header header; char data[BINARY_STREAM_PACKET_SIZE]; };
+    static Slot window[BINARY_STREAM_WINDOW];
+    static uint8_t window_head, window_count;
+
+    // Acknowledge and dispatch the oldest packets, all of them if 'force'd
+    void service(const bool force=false) {
+      while (window_count && (force || card.uploadReady())) {
+        Slot &slot = window[window_head];
+        SERIAL_ECHOLNPGM("ok", slot.header.sync);
+        dispatch(slot.header, slot.data);
+        window_head = (window_head + 1) % window_size;
+        window_count--;
+      }
+    }
+  #endif
+
   // fletchers 16 checksum
   uint32_t checksum(uint32_t cs, uint8_t value) {
     uint16_t cs_low = (((cs & 0xFF) + value) % 255);
@@ -278,6 +362,8 @@ public:
 
   template<const size_t buffer_size>
   void receive(char (&buffer)[buffer_size]) {
+    // Payloads go into the window's slots if it has them
+    constexpr size_t packet_size = TERN(BINARY_STREAM_UPLOAD, BINARY_STREAM_PACKET_SIZE, buffer_size);
     uint8_t data = 0;
     millis_t transfer_window = millis() + rx_timeslice;
 
@@ -322,22 +408,26 @@ public:
             if (packet.header.checksum == packet.header_checksum) {
               // The SYNC control packet is a special case in that it doesn't require the stream sync to be correct
               if (static_cast<Protocol>(packet.header.protocol()) == Protocol::CONTROL && static_cast<ProtocolControl>(packet.header.type()) == ProtocolControl::SYNC) {
-                  SERIAL_ECHOLN(F("ss"), sync, C(','), buffer_size, C(','), version_major, C('.'), version_minor, C('.'), version_patch);
+                  TERN_(BINARY_STREAM_UPLOAD, service(true));
+                  TERN_(BINARY_STREAM_UPLOAD, SERIAL_ECHOLNPGM("sw", window_size));
+                  SERIAL_ECHOLN(F("ss"), sync, C(','), packet_size, C(','), version_major, C('.'), version_minor, C('.'), version_patch);
                   stream_state = StreamState::PACKET_RESET;
                   break;
               }
               if (packet.header.sync == sync) {
                 buffer_next_index = 0;
                 packet.bytes_received = 0;
-                if (packet.header.size) {
-                  stream_state = StreamState::PACKET_DATA;
+                #if ENABLED(BINARY_STREAM_UPLOAD)
+                  if (window_count == window_size) service(true);  // More than the window, so make room
+                  packet.buffer = window[(window_head + window_count) % window_size].data;
+                #else
                   packet.buffer = static_cast<char *>(&buffer[0]); // multipacket buffering not implemented, always allocate whole buffer to packet
-                }
-                else
-                  stream_state = StreamState::PACKET_PROCESS;
+                #endif
+                stream_state = packet.header.size ? StreamState::PACKET_DATA : StreamState::PACKET_PROCESS;
               }
-              else if (packet.header.sync == sync - 1) {           // ok response must have been lost
-                SERIAL_ECHOLNPGM("ok", packet.header.sync);  // transmit valid packet received and drop the payload
+              else if (uint8_t(sync - packet.header.sync) <= window_size) { // ok response must have been lost
+                // Drop the payload. Its 'ok' is still to come if it's in the window.
+                if (!TERN0(BINARY_STREAM_UPLOAD, window_count)) SERIAL_ECHOLNPGM("ok", uint8_t(sync - 1));
                 stream_state = StreamState::PACKET_RESET;
               }
               else if (packet_retries) {
@@ -357,7 +447,7 @@ public:
         case StreamState::PACKET_DATA:
           if (!stream_read(data)) break;
 
-          if (buffer_next_index < buffer_size)
+          if (buffer_next_index < packet_size)
             packet.buffer[buffer_next_index] = data;
           else {
             SERIAL_ECHO_MSG("Datastream packet data buffer overrun");
@@ -393,8 +483,13 @@ public:
           packet_retries = 0;
           bytes_received += packet.header.size;
 
-          SERIAL_ECHOLNPGM("ok", packet.header.sync); // transmit valid packet received
-          dispatch();
+          #if ENABLED(BINARY_STREAM_UPLOAD)
+            window[(window_head + window_count++) % window_size].header = packet.header;
+            service();
+          #else
+            SERIAL_ECHOLNPGM("ok", packet.header.sync); // transmit valid packet received
+            dispatch(packet.header, packet.buffer);
+          #endif
           stream_state = StreamState::PACKET_RESET;
           break;
         case StreamState::PACKET_RESEND:
@@ -422,10 +517,10 @@ public:
     #pragma GCC diagnostic pop
   }
 
-  void dispatch() {
-    switch (static_cast<Protocol>(packet.header.protocol())) {
+  void dispatch(Packet::Header &header, char *buffer) {
+    switch (static_cast<Protocol>(header.protocol())) {
       case Protocol::CONTROL:
-        switch (static_cast<ProtocolControl>(packet.header.type())) {
+        switch (static_cast<ProtocolControl>(header.type())) {
           case ProtocolControl::CLOSE: // revert back to ASCII mode
             card.flag.binary_mode = false;
             break;
@@ -434,7 +529,7 @@ public:
         }
         break;
       case Protocol::FILE_TRANSFER:
-        SDFileTransferProtocol::process(packet.header.type(), packet.buffer, packet.header.size); // send user data to be processed
+        SDFileTransferProtocol::process(header.type(), buffer, header.size); // send user data to be processed
       break;
       default:
         SERIAL_ECHO_MSG("Unsupported Binary Protocol");
@@ -442,11 +537,13 @@ public:
   }
 
   void idle() {
+    TERN_(BINARY_STREAM_UPLOAD, service());
     // Some Protocols may need periodic updates without new data
     SDFileTransferProtocol::idle();
   }
 
-  static const uint16_t packet_max_wait = 500, rx_timeslice = 20, max_retries = 0, version_major = 0, version_minor = 1, version_patch = 0;
+  static const uint16_t packet_max_wait = 500, rx_timeslice = 20, max_retries = 0, version_major = 0, version_minor = TERN(BINARY_STREAM_UPLOAD, 2, 1), version_patch = 0;
+  static const uint8_t window_size = TERN(BINARY_STREAM_UPLOAD, BINARY_STREAM_WINDOW, 1);
   uint8_t  packet_retries, sync;
   uint16_t buffer_next_index;
   uint32_t bytes_received;
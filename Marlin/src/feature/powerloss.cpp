@@ -49,6 +49,11 @@ uint8_t PrintJobRecovery::queue_index_r;
 uint32_t PrintJobRecovery::cmd_sdpos, // = 0
          PrintJobRecovery::sdpos[BUFSIZE];
 
+#if ENABLED(POWER_LOSS_JOURNAL)
+  PowerLossJournal<job_recovery_info_t, job_journal_record_t, POWER_LOSS_JOURNAL_BLOCKS> PrintJobRecovery::journal;
+  uint16_t PrintJobRecovery::journal_state_crc;
+#endif
+
 
 #if ENABLED(DWIN_CREALITY_LCD)
   bool PrintJobRecovery::dwin_flag; // = false
@@ -67,6 +72,10 @@ uint32_t PrintJobRecovery::cmd_sdpos, // = 0
 #include "../module/printcounter.h"
 #include "../module/temperature.h"
 
+#if ENABLED(POWER_LOSS_JOURNAL)
+  #include "../libs/crc16.h"
+#endif
+
 #if HOMING_Z_WITH_PROBE
   #include "../module/probe.h"
 #endif
@@ -101,6 +110,88 @@ PrintJobRecovery recovery;
     gcode.process_subcommands_now(cmd); \
   }while(0)
 
+#if ENABLED(POWER_LOSS_JOURNAL)
+
+  // Copy the journaled fields between the recovery info and a record
+  static void fill(job_journal_record_t &r, const job_recovery_info_t &i) {
+    r.sdpos = i.sdpos;
+    r.current_position = i.current_position;
+    r.print_job_elapsed = i.print_job_elapsed;
+    r.feedrate = i.feedrate;
+    r.feedrate_percentage = i.feedrate_percentage;
+    r.zraise = i.zraise;
+    r.raised = i.flag.raised;
+    TERN_(HAS_HOTEND, COPY(r.target_temperature, i.target_temperature));
+    TERN_(HAS_HEATED_BED, r.target_temperature_bed = i.target_temperature_bed);
+    TERN_(HAS_FAN, COPY(r.fan_speed, i.fan_speed));
+  }
+
+  static void apply(const job_journal_record_t &r, job_recovery_info_t &i) {
+    i.sdpos = r.sdpos;
+    i.current_position = r.current_position;
+    i.print_job_elapsed = r.print_job_elapsed;
+    i.feedrate = r.feedrate;
+    i.feedrate_percentage = r.feedrate_percentage;
+    i.zraise = r.zraise;
+    i.flag.raised = r.raised;
+    TERN_(HAS_HOTEND, COPY(i.target_temperature, r.target_temperature));
+    TERN_(HAS_HEATED_BED, i.target_temperature_bed = r.target_temperature_bed);
+    TERN_(HAS_FAN, COPY(i.fan_speed, r.fan_speed));
+  }
+
+  // CRC of the recovery info without the journaled fields, to see when a record won't do
+  static uint16_t state_crc(const job_recovery_info_t &i) {
+    job_recovery_info_t s;
+    memcpy((void*)&s, (const void*)&i, sizeof(s));
+    apply(job_journal_record_t{}, s);
+    s.valid_head = s.valid_foot = 0;
+    uint16_t crc = 0;
+    crc16(&crc, &s, sizeof(s));
+    return crc;
+  }
+
+  /**
+   * Open the journal in the recovery file. With 'create' make the file
+   * if it's missing or unsuitable, and erase it.
+   */
+  bool PrintJobRecovery::journal_open(const bool create) {
+    if (journal.isOpen()) return true;
+    bool created = false;
+    const uint32_t first = card.jobRecoveryJournal(uint32_t(POWER_LOSS_JOURNAL_BLOCKS) * 512, create, &created);
+    journal_state_crc = 0;
+    return first && journal.open(card.diskIODriver(), first, created);
+  }
+
+  /**
+   * Save the recovery info to the journal: the full info on the first save of
+   * a session, when forced, or when fields other than the record's changed.
+   * Otherwise just a record.
+   */
+  void PrintJobRecovery::journal_write(const bool full) {
+    debug(F("Write"));
+
+    const bool was_open = journal.isOpen();
+    if (!journal_open(true)) {
+      DEBUG_ECHOLNPGM("Power-loss journal open failed.");
+      return;
+    }
+
+    bool ok;
+    const uint16_t crc = state_crc(info);
+    if (full || !was_open || crc != journal_state_crc) {
+      ok = journal.writeState(info);
+      if (ok) journal_state_crc = crc;
+    }
+    else {
+      job_journal_record_t record;
+      fill(record, info);
+      ok = journal.writeRecord(record);
+    }
+    if (!ok) DEBUG_ECHOLNPGM("Power-loss journal write failed.");
+  }
+
+#endif // POWER_LOSS_JOURNAL
+
 /**
  * Clear the recovery info
  */
@@ -151,6 +242,7 @@ bool PrintJobRecovery::check() {
  */
 void PrintJobRecovery::purge() {
   init();
+  TERN_(POWER_LOSS_JOURNAL, journal.close());
   card.removeJobRecoveryFile();
 }
 
@@ -158,11 +250,23 @@ void PrintJobRecovery::purge() {
  * Load the recovery data, if it exists
  */
 void PrintJobRecovery::load() {
-  if (exists()) {
-    open(true);
-    (void)file.read(&info, sizeof(info));
-    close();
-  }
+  #if ENABLED(POWER_LOSS_JOURNAL)
+    init();
+    if (journal_open(false)) {
+      job_journal_record_t record;
+      bool has_record;
+      if (!journal.load(info, record, has_record))
+        init();
+      else if (has_record)
+        apply(record, info);
+    }
+  #else
+    if (exists()) {
+      open(true);
+      (void)file.read(&info, sizeof(info));
+      close();
+    }
+  #endif
   debug(F("Load"));
 }
 
@@ -267,7 +371,11 @@ void PrintJobRecovery::save(const bool force/*=false*/, const float zraise/*=POW
     info.flag.dryrun = !!(marlin_debug_flags & MARLIN_DEBUG_DRYRUN);
     info.flag.allow_cold_extrusion = TERN0(PREVENT_COLD_EXTRUSION, thermalManager.allow_cold_extrude);
 
-    write();
+    #if ENABLED(POWER_LOSS_JOURNAL)
+      journal_write(force);
+    #else
+      write();
+    #endif
   }
 }
 
@@ -57,6 +57,10 @@
 //#define SAVE_EACH_CMD_MODE
 //#define SAVE_INFO_INTERVAL_MS 0
 
+#if ENABLED(POWER_LOSS_JOURNAL) && !defined(SAVE_INFO_INTERVAL_MS)
+  #define SAVE_INFO_INTERVAL_MS POWER_LOSS_JOURNAL_MS // Journal records are cheap enough to save on a timer too
+#endif
+
 typedef struct {
   uint8_t valid_head;
 
@@ -153,6 +157,32 @@ typedef struct {
 
 } job_recovery_info_t;
 
+#if ENABLED(POWER_LOSS_JOURNAL)
+
+  #include "powerloss_journal.h"
+
+  // The recovery info that changes as a job prints, journaled between full saves
+  typedef struct {
+    uint32_t sdpos;
+    xyze_pos_t current_position;
+    millis_t print_job_elapsed;
+    uint16_t feedrate;
+    int16_t feedrate_percentage;
+    float zraise;
+    bool raised;
+    #if HAS_HOTEND
+      celsius_t target_temperature[HOTENDS];
+    #endif
+    #if HAS_HEATED_BED
+      celsius_t target_temperature_bed;
+    #endif
+    #if HAS_FAN
+      uint8_t fan_speed[FAN_COUNT];
+    #endif
+  } job_journal_record_t;
+
+#endif
+
 class PrintJobRecovery {
   public:
     static const char filename[5];
@@ -243,6 +273,13 @@ class PrintJobRecovery {
   private:
     static void write();
 
+    #if ENABLED(POWER_LOSS_JOURNAL)
+      static PowerLossJournal<job_recovery_info_t, job_journal_record_t, POWER_LOSS_JOURNAL_BLOCKS> journal;
+      static uint16_t journal_state_crc;
+      static bool journal_open(const bool create);
+      static void journal_write(const bool full);
+    #endif
+
     #if ENABLED(BACKUP_POWER_SUPPLY)
       static void retract_and_lift(const float zraise);
     #endif
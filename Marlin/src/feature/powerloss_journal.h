@@ -0,0 +1,191 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2024 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+/**
+ * feature/powerloss_journal.h - Journal for power-loss recovery data
+ *
+ * The journal is a contiguous, pre-erased run of blocks that is written
+ * straight through the media driver, so a save never touches the FAT or
+ * the directory and costs a single block write:
+ *
+ *  - Blocks 0 and 1 hold the full State, written alternately so the last
+ *    good copy survives an interrupted write.
+ *  - The other blocks are a ring of small Records packed into blocks.
+ *    A save adds one Record and writes the block it lands in.
+ *
+ * Every entry has a sequence number and a CRC. Loading takes the newest valid
+ * State and applies the newest valid Record saved after it. A torn State write
+ * leaves the other State block. A save rewrites the whole ring block, so a torn
+ * Record write can also spoil the earlier Records in that block, and loading
+ * then falls back to the last Record of the block before, at most one block
+ * of Records back.
+ */
+
+#include "../sd/disk_io_driver.h"
+#include "../libs/crc16.h"
+
+#include <string.h>
+
+template<typename State, typename Record, uint16_t BLOCKS>
+class PowerLossJournal {
+  private:
+    struct StateEntry { uint32_t seq; State state; uint16_t crc; };
+    struct RecordEntry { uint32_t seq; Record record; uint16_t crc; };
+
+    static_assert(BLOCKS >= 4, "The journal needs at least 4 blocks.");
+    static_assert(sizeof(StateEntry) <= 512, "The journal State must fit in a block.");
+
+    static constexpr uint16_t ring_blocks = BLOCKS - 2;
+    static constexpr uint8_t per_block = 512 / sizeof(RecordEntry);
+
+    DiskIODriver *driver;
+    uint32_t first = 0,           // First block, or 0 when closed
+             seq;                 // Sequence number of the newest entry
+    uint16_t block;               // Ring block for the next Record
+    uint8_t slot,                 // Slot in that block for the next Record
+            state_block;          // Block with the newest State
+    alignas(4) uint8_t buffer[512]; // Image of the ring block being filled
+
+    template<typename Entry>
+    static uint16_t crc(const Entry &e) {
+      uint16_t c = 0;
+      crc16(&c, &e, offsetof(Entry, crc));
+      return c;
+    }
+
+    template<typename Entry>
+    static bool valid(const Entry &e) { return e.seq && e.crc == crc(e); }
+
+    // Move on to a fresh ring block
+    void next_block() {
+      memset(buffer, 0, sizeof(buffer));
+      slot = 0;
+      if (++block == ring_blocks) block = 0;
+    }
+
+    /**
+     * Read the whole journal for the newest State and the newest Record after it.
+     * The next Record goes into the block after the newest entry in the ring.
+     * Return false if there's no valid State.
+     */
+    bool scan(State * const state, Record * const record, bool * const has_record) {
+      uint32_t state_seq = 0, record_seq = 0;
+      seq = block = 0;
+      state_block = 1;
+
+      for (uint8_t b = 0; b < 2; ++b) {
+        if (!driver->readBlock(first + b, buffer)) return false;
+        const StateEntry &e = *reinterpret_cast<const StateEntry*>(buffer);
+        if (!valid(e) || e.seq <= state_seq) continue;
+        state_seq = e.seq;
+        state_block = b;
+        if (state) memcpy((void*)state, (const void*)&e.state, sizeof(State));
+      }
+      seq = state_seq;
+
+      for (uint16_t b = 0; b < ring_blocks; ++b) {
+        if (!driver->readBlock(first + 2 + b, buffer)) return false;
+        for (uint8_t i = 0; i < per_block; ++i) {
+          const RecordEntry &e = reinterpret_cast<const RecordEntry*>(buffer)[i];
+          if (!valid(e)) continue;
+          if (e.seq > seq) { seq = e.seq; block = b; }
+          if (e.seq > state_seq && e.seq > record_seq) {
+            record_seq = e.seq;
+            if (record) memcpy((void*)record, (const void*)&e.record, sizeof(Record));
+          }
+        }
+      }
+      if (has_record) *has_record = record_seq != 0;
+
+      // Records go on after the newest one, in a block of their own
+      next_block();
+      return state_seq != 0;
+    }
+
+  public:
+    bool isOpen() const { return first != 0; }
+    void close() { first = 0; }
+
+    /**
+     * Open the journal starting at block 'bgn'. With 'erase' clear it first
+     * with one multi-block write, otherwise find where the last session ended.
+     */
+    bool open(DiskIODriver * const drv, const uint32_t bgn, const bool erase) {
+      driver = drv;
+      first = bgn;
+      if (erase) {
+        memset(buffer, 0, sizeof(buffer));
+        bool ok = driver->writeStart(first, BLOCKS);
+        for (uint16_t b = 0; ok && b < BLOCKS; ++b) ok = driver->writeData(buffer);
+        if (driver->writeStop() && ok) {
+          seq = block = slot = 0;
+          state_block = 1;
+          return true;
+        }
+      }
+      else {
+        scan(nullptr, nullptr, nullptr);
+        return true;
+      }
+      first = 0;
+      return false;
+    }
+
+    /**
+     * Load the newest State with the newest Record saved after it, if any.
+     * Return false if there's no valid State.
+     */
+    bool load(State &state, Record &record, bool &has_record) {
+      has_record = false;
+      return isOpen() && scan(&state, &record, &has_record);
+    }
+
+    // Write the full State into the block not holding the newest one
+    bool writeState(const State &state) {
+      if (!isOpen()) return false;
+      memset(buffer, 0, sizeof(buffer));
+      StateEntry &e = *reinterpret_cast<StateEntry*>(buffer);
+      e.seq = ++seq;
+      memcpy((void*)&e.state, (const void*)&state, sizeof(State));
+      e.crc = crc(e);
+      const uint8_t b = state_block ^ 1;
+      const bool ok = driver->writeBlock(first + b, buffer);
+      if (ok) state_block = b;
+
+      // Earlier Records are superseded, so don't rewrite them
+      if (slot) next_block(); else memset(buffer, 0, sizeof(buffer));
+      return ok;
+    }
+
+    // Add a Record and rewrite the block it lands in, with the Records before it
+    bool writeRecord(const Record &record) {
+      if (!isOpen()) return false;
+      RecordEntry &e = reinterpret_cast<RecordEntry*>(buffer)[slot];
+      e.seq = ++seq;
+      memcpy((void*)&e.record, (const void*)&record, sizeof(Record));
+      e.crc = crc(e);
+      const bool ok = driver->writeBlock(first + 2 + block, buffer);
+      if (++slot == per_block) next_block();
+      return ok;
+    }
+};
@@ -0,0 +1,114 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "../inc/MarlinConfig.h"
+
+#if ENABLED(PLANNER_STARVATION_PROFILE)
+
+#include "starvation.h"
+#include "../module/planner.h"
+#include "../MarlinCore.h"
+
+#if HAS_MEDIA
+  #include "../sd/cardreader.h"
+#endif
+
+StarvationProfile starvation_profile;
+
+starvation_t StarvationProfile::data;
+bool StarvationProfile::in_job, StarvationProfile::printing, StarvationProfile::stepping, StarvationProfile::pending;
+millis_t StarvationProfile::idle_since;
+float StarvationProfile::last_mm, StarvationProfile::last_rate;
+
+void StarvationProfile::update() {
+  // Each print job starts a fresh profile, kept after it ends for M1013 and the print-complete screen
+  const bool job = printJobOngoing() || printingIsPaused();
+  if (job && !in_job) reset();
+  in_job = job;
+
+  printing = printingIsActive();
+  if (printing) data.depth[planner.movesplanned()]++;
+
+  if (pending) {
+    hal.isr_off();
+    pending = false;
+    latest().sdpos = TERN0(HAS_MEDIA, card.isStillPrinting() ? card.getIndex() : 0);
+    hal.isr_on();
+  }
+
+  // Close the idle stretch of a print that ended (or was paused) while starved
+  if (!printing && idle_since) {
+    hal.isr_off();
+    if (idle_since) end_idle(millis());
+    hal.isr_on();
+  }
+}
+
+void StarvationProfile::reset() {
+  hal.isr_off();
+  data = {};
+  data.since = millis();
+  idle_since = 0;
+  pending = false;
+  hal.isr_on();
+}
+
+void StarvationProfile::report() {
+  // Take a consistent copy; the ISR keeps counting
+  hal.isr_off();
+  const starvation_t d = data;
+  const millis_t idle = idle_since ? millis() - idle_since : 0;
+  hal.isr_on();
+
+  uint32_t samples = 0;
+  uint64_t sum = 0;
+  for (uint8_t i = 0; i <= BLOCK_BUFFER_SIZE; ++i) { samples += d.depth[i]; sum += uint64_t(d.depth[i]) * i; }
+
+  SERIAL_ECHO_MSG("Planner underruns:", d.underruns, " idle:", d.idle_ms + idle, "ms longest:", _MAX(d.max_idle_ms, idle),
+                  "ms over ", millis() - d.since, "ms avg depth:", p_float_t(samples ? float(sum) / samples : 0.0f, 1), "/", BLOCK_BUFFER_SIZE);
+
+  // Depth histogram in eighths of the buffer, as a share of the samples
+  SERIAL_ECHO_START();
+  SERIAL_ECHOPGM("depth %:");
+  for (uint8_t b = 0; b < 8; ++b) {
+    uint32_t n = 0;
+    for (uint8_t i = b * BLOCK_BUFFER_SIZE / 8; i < (b + 1) * BLOCK_BUFFER_SIZE / 8; ++i) n += d.depth[i];
+    if (b == 7) n += d.depth[BLOCK_BUFFER_SIZE];
+    SERIAL_ECHO(b ? F(",") : F(" "), samples ? uint32_t(uint64_t(n) * 100 / samples) : 0);
+  }
+  SERIAL_EOL();
+
+  // Latest underruns, oldest first
+  const uint8_t count = _MIN(d.underruns, uint32_t(STARVATION_EVENTS));
+  for (uint8_t i = 0; i < count; ++i) {
+    const underrun_t &e = d.event[(d.head + STARVATION_EVENTS - count + i) % STARVATION_EVENTS];
+    SERIAL_ECHO_MSG("underrun at ", e.ms, "ms file:", e.sdpos, " after ", p_float_t(e.mm, 2), "mm at ",
+                    p_float_t(e.rate, 1), "mm/s idle:", e.idle_ms, "ms");
+  }
+}
+
+void StarvationProfile::summary(char *str) {
+  const uint32_t idle = data.idle_ms;
+  sprintf_P(str, PSTR("Underruns:%lu Idle:%lu.%lus"), (unsigned long)data.underruns, (unsigned long)(idle / 1000), (unsigned long)((idle % 1000) / 100));
+}
+
+#endif // PLANNER_STARVATION_PROFILE
@@ -0,0 +1,107 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+/**
+ * starvation.h - Planner starvation (underrun) profile
+ *
+ * The stepper side runs in the Stepper ISR through Planner::get_current_block():
+ * an underrun is the stepper finding the planner empty after running a block
+ * while printing, and its idle time lasts until the next block is delivered.
+ * The main side runs from GCodeQueue::advance(): it samples the planner depth
+ * and adds the file position to the underruns the ISR has recorded.
+ * The profile restarts with each print job and is kept after it ends.
+ */
+
+#include "../inc/MarlinConfigPre.h"
+
+#ifndef STARVATION_EVENTS
+  #define STARVATION_EVENTS 8   // Most recent underruns kept for the report
+#endif
+
+typedef struct {
+  millis_t ms;          // When the stepper ran out of blocks
+  uint32_t sdpos;       // File position being read at the time (0 if not printing from media)
+  uint32_t idle_ms;     // Time until the next block arrived
+  float mm,             // Length of the last block before the underrun
+        rate;           // Its nominal speed in mm/s
+} underrun_t;
+
+typedef struct {
+  uint32_t depth[BLOCK_BUFFER_SIZE + 1];  // Main loop passes at each planner depth while printing
+  uint32_t underruns,                     // Underruns since reset
+           idle_ms,                       // Total time the stepper sat idle mid-print
+           max_idle_ms;                   // Longest idle stretch
+  underrun_t event[STARVATION_EVENTS];    // Ring of the latest underruns
+  uint8_t head;                           // Next slot in the ring
+  millis_t since;
+} starvation_t;
+
+class StarvationProfile {
+  static bool in_job, printing, stepping, pending;
+  static millis_t idle_since;
+  static float last_mm, last_rate;
+
+  static underrun_t& latest() { return data.event[(data.head + STARVATION_EVENTS - 1) % STARVATION_EVENTS]; }
+
+  static void end_idle(const millis_t ms) {
+    const millis_t d = ms - idle_since;
+    data.idle_ms += d;
+    NOLESS(data.max_idle_ms, d);
+    latest().idle_ms = d;
+    idle_since = 0;
+  }
+
+public:
+  static starvation_t data;
+
+  // The stepper took a block. Called from the ISR only.
+  static void block_started(const float mm, const float rate) {
+    if (idle_since) end_idle(millis());
+    stepping = true;
+    last_mm = mm;
+    last_rate = rate;
+  }
+
+  // The stepper found the planner empty. Called from the ISR only.
+  static void ran_dry() {
+    if (!stepping) return;
+    stepping = false;
+    if (!printing) return;
+    const millis_t ms = millis();
+    underrun_t &e = data.event[data.head];
+    e = { ms, 0, 0, last_mm, last_rate };
+    data.head = (data.head + 1) % STARVATION_EVENTS;
+    data.underruns++;
+    idle_since = ms ? ms : 1;
+    pending = true;
+  }
+
+  static void update();   // From GCodeQueue::advance()
+  static void reset();
+  static void report();
+
+  // A short summary for the print-complete screen
+  static void summary(char *str);
+};
+
+extern StarvationProfile starvation_profile;
@@ -0,0 +1,72 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "../inc/MarlinConfig.h"
+
+#if ENABLED(STEPPER_ISR_PROFILE)
+
+#include "stepper_profile.h"
+
+StepperProfile stepper_profile;
+
+isr_profile_t StepperProfile::data;
+
+void StepperProfile::reset() {
+  hal.isr_off();
+  data = {};
+  data.since = millis();
+  hal.isr_on();
+}
+
+void StepperProfile::report() {
+  // Take a consistent copy; the ISR keeps counting
+  hal.isr_off();
+  const isr_profile_t d = data;
+  hal.isr_on();
+
+  constexpr uint32_t cycles_per_us = (F_CPU) / 1000000UL;
+  const millis_t ms = millis() - d.since;
+  const isr_phase_stats_t &t = d.phase[ISR_TOTAL];
+
+  // Share of the CPU spent in the ISR body (entry and exit are not counted)
+  const float load = ms ? 100.0f * float(t.sum) / (float(ms) * ((F_CPU) / 1000UL)) : 0.0f;
+  SERIAL_ECHO_MSG("Stepper ISR load:", p_float_t(load, 1), "% over ", ms, "ms calls:", t.count,
+                  " rate:", ms ? uint32_t(uint64_t(t.count) * 1000 / ms) : 0, "/s late:", d.late, " catch-up:", d.catch_up);
+
+  static const char * const names[] = { "isr", "pulse", "block", "advance" };
+  for (uint8_t p = 0; p < ISR_PHASES; ++p) {
+    const isr_phase_stats_t &s = d.phase[p];
+    if (!s.count) continue;
+    SERIAL_ECHO_START();
+    SERIAL_ECHO(names[p], F(" n:"), s.count, F(" min:"), s.min, F(" avg:"), uint32_t(s.sum / s.count),
+                F(" max:"), s.max, F(" cyc ("), s.max / cycles_per_us, F("us) hist:"));
+    for (uint8_t b = 0; b < ISR_PROFILE_BINS; ++b) SERIAL_ECHO(C(b ? ',' : ' '), s.hist[b]);
+    SERIAL_EOL();
+  }
+
+  SERIAL_ECHO_START();
+  SERIAL_ECHOPGM("Multistep up:", d.ms_up, " down:", d.ms_down, " levels:");
+  for (uint8_t l = 0; l < 8 && _BV(l) <= MULTISTEPPING_LIMIT; ++l) SERIAL_ECHO(C(' '), C('x'), _BV(l), C(':'), d.level[l]);
+  SERIAL_ECHOLNPGM(" blocks:", d.blocks, " smoothed:", d.smoothed);
+}
+
+#endif // STEPPER_ISR_PROFILE
@@ -0,0 +1,87 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+/**
+ * stepper_profile.h - Cycle accounting for the Stepper ISR
+ *
+ * Each phase is timed with the DWT cycle counter, which calibrate_delay_loop()
+ * starts at boot. Histogram bins are powers of two: bin 0 is < 256 cycles,
+ * each following bin doubles, and the last bin holds everything above.
+ */
+
+#include "../inc/MarlinConfigPre.h"
+
+#define ISR_PROFILE_BINS 8
+
+enum ISRPhase : uint8_t { ISR_TOTAL, ISR_PULSE, ISR_BLOCK, ISR_ADVANCE, ISR_PHASES };
+
+typedef struct {
+  uint32_t count, min, max;
+  uint64_t sum;
+  uint32_t hist[ISR_PROFILE_BINS];
+} isr_phase_stats_t;
+
+typedef struct {
+  isr_phase_stats_t phase[ISR_PHASES];
+  uint32_t late,            // ISRs that ended past the next step time and were cut short
+           catch_up,        // Extra passes of the ISR loop to catch up with due events
+           ms_up, ms_down,  // Multi-stepping doubled / halved
+           level[8],        // ISRs run at each multi-stepping level (x1, x2, x4...)
+           blocks,          // Blocks started
+           smoothed;        // Blocks started with step smoothing (oversampling)
+  millis_t since;
+} isr_profile_t;
+
+class StepperProfile {
+public:
+  static isr_profile_t data;
+
+  static uint32_t now() { return *(volatile uint32_t *)0xE0001004; } // DWT->CYCCNT
+
+  // Account the cycles since 'start' to a phase. Called from the ISR only.
+  static void add(const ISRPhase p, const uint32_t start) {
+    const uint32_t c = now() - start;
+    isr_phase_stats_t &s = data.phase[p];
+    s.count++;
+    s.sum += c;
+    if (s.count == 1 || c < s.min) s.min = c;
+    if (c > s.max) s.max = c;
+    const uint8_t b = c < 256 ? 0 : 32 - 8 - __builtin_clz(c);  // 256-511 => 1, ...
+    s.hist[_MIN(b, ISR_PROFILE_BINS - 1)]++;
+  }
+
+  static void isr_done(const uint32_t start, const uint8_t steps_per_isr, const uint8_t loops) {
+    add(ISR_TOTAL, start);
+    data.level[__builtin_ctz(steps_per_isr) & 7]++;
+    if (loops > 1) data.catch_up += loops - 1;
+  }
+
+  static void block_started(const bool smoothed) { data.blocks++; if (smoothed) data.smoothed++; }
+
+  static void reset();
+  static void report();
+};
+
+extern StepperProfile stepper_profile;
+
+#define ISR_PROFILE(P, CODE) do{ const uint32_t _isr_t0 = StepperProfile::now(); CODE; StepperProfile::add(P, _isr_t0); }while(0)
@@ -157,6 +157,34 @@ public:
   constexpr grid_count_t G29_State::abl_points;
 #endif
 
+#if ENABLED(BLTOUCH_FAST_MESH)
+
+  /**
+   * Predict the bed Z at mesh point 'm' from the points probed before it on the serpentine path.
+   * 'in_back' steps back along the current row, 'out_back' to the row before it.
+   * With both neighbors and their corner, continue the plane through them.
+   * Otherwise use the one neighbor there is, or NAN for the first point.
+   */
+  static float predict_mesh_z(const bed_mesh_t &z, const float z_offset, const xy_int8_t &m, const xy_int8_t &in_back, const xy_int8_t &out_back) {
+    auto probed = [](const xy_int8_t &p) {
+      return WITHIN(p.x, 0, (GRID_MAX_POINTS_X) - 1) && WITHIN(p.y, 0, (GRID_MAX_POINTS_Y) - 1);
+    };
+    const xy_int8_t a = m + in_back, b = m + out_back, c = a + out_back;
+    const bool has_a = probed(a), has_b = probed(b);
+    float zp;
+    if (has_a && has_b)
+      zp = z[a.x][a.y] + z[b.x][b.y] - z[c.x][c.y];
+    else if (has_a)
+      zp = z[a.x][a.y];
+    else if (has_b)
+      zp = z[b.x][b.y];
+    else
+      return NAN;
+    return zp - z_offset;
+  }
+
+#endif
+
 /**
  * G29: Bed Leveling
  *
@@ -224,6 +252,9 @@ public:
  *     E<bool>  By default G29 will engage the Z probe, test the bed, then disengage
  *              Include "E" to engage/disengage the Z probe for each sample.
  *              There's no extra effect if you have a fixed Z probe.
+ *
+ *   With BLTOUCH_FAST_MESH:
+ *     K<bool>  Fast mesh in HIGH SPEED mode. Without 'K1' each point is probed the usual way.
  */
 G29_TYPE GcodeSuite::G29() {
 
@@ -235,6 +266,8 @@ G29_TYPE GcodeSuite::G29() {
   // Keep powered steppers from timing out
   reset_stepper_timeout();
 
+  const millis_t g29_start_ms = millis();
+
   G29_flag = true;
   for(int x = 0; x < GRID_MAX_POINTS_X; x ++)
   {
@@ -259,6 +292,11 @@ G29_TYPE GcodeSuite::G29() {
          no_action = seenA || seenQ,
               faux = ENABLED(DEBUG_LEVELING_FEATURE) && DISABLED(PROBE_MANUALLY) ? parser.boolval('C') : no_action;
 
+  // K<bool> = Fast mesh: pin kept deployed, travel with the raise, second probe only when needed
+  #if ENABLED(BLTOUCH_FAST_MESH)
+    const bool fast_mesh = !faux && bltouch.high_speed_mode && parser.boolval('K');
+  #endif
+
   // O = Don't level if leveling is already active
   if (!no_action && planner.leveling_active && parser.boolval('O')) {
     if (DEBUGGING(LEVELING)) DEBUG_ECHOLNPGM("> Auto-level not needed, skip");
@@ -475,8 +513,10 @@ G29_TYPE GcodeSuite::G29() {
           rts.sendData(1, Wait_VP);
           rts.gotoPage(ID_ABL_HeatWait_L, ID_ABL_HeatWait_D);
         #endif
+        // For a fast mesh only set the targets here. Heating continues during the travel to the first point.
         if (!abl.dryrun) probe.preheat_for_probing(LEVELING_NOZZLE_TEMP,
-          TERN(EXTENSIBLE_UI, ExtUI::getLevelingBedTemp(), LEVELING_BED_TEMP)
+          TERN(EXTENSIBLE_UI, ExtUI::getLevelingBedTemp(), LEVELING_BED_TEMP),
+          TERN0(BLTOUCH_FAST_MESH, fast_mesh)
         );
       #endif
     }
@@ -689,6 +729,27 @@ G29_TYPE GcodeSuite::G29() {
 
     abl.measured_z = 0;
 
+    #if ENABLED(BLTOUCH_FAST_MESH)
+      grid_count_t reprobes = 0;
+      millis_t heat_wait_ms = 0;
+      if (fast_mesh) {
+        // Head for the first point (the first row runs toward RIGHT / BACK) while the heaters finish
+        xy_int8_t first = { 0, 0 };
+        TERN(PROBE_Y_FIRST, first.y, first.x) = (PR_OUTER_SIZE & 1) ? 0 : PR_INNER_SIZE - 1;
+        destination = current_position;
+        destination.set(abl.probe_position_lf + abl.gridSpacing * first.asFloat() - probe.offset_xy);
+        NOLESS(destination.z, Z_TWEEN_SAFE_CLEARANCE);
+        prepare_line_to_destination();
+        #if ENABLED(PREHEAT_BEFORE_LEVELING)
+          if (!abl.dryrun) {
+            const millis_t ms = millis();
+            probe.preheat_for_probing(LEVELING_NOZZLE_TEMP, TERN(EXTENSIBLE_UI, ExtUI::getLevelingBedTemp(), LEVELING_BED_TEMP));
+            heat_wait_ms = millis() - ms;
+          }
+        #endif
+      }
+    #endif
+
     #if ABL_USES_GRID
 
       bool zig = PR_OUTER_SIZE & 1;  // Always end at RIGHT and BACK_PROBE_BED_POSITION
@@ -787,7 +848,18 @@ G29_TYPE GcodeSuite::G29() {
 
           #else // !BD_SENSOR_PROBE_NO_STOP
 
-            abl.measured_z = faux ? 0.001f * random(-100, 101) : probe.probe_at_point(abl.probePos, raise_after, abl.verbose_level);
+            #if ENABLED(BLTOUCH_FAST_MESH)
+              if (fast_mesh) {
+                constexpr xy_int8_t out_back = { -int8_t(ENABLED(PROBE_Y_FIRST)), -int8_t(DISABLED(PROBE_Y_FIRST)) };
+                const xy_int8_t in_back = { int8_t(TERN(PROBE_Y_FIRST, 0, -inInc)), int8_t(TERN(PROBE_Y_FIRST, -inInc, 0)) };
+                bool reprobed;
+                abl.measured_z = probe.probe_mesh_point(abl.probePos,
+                  predict_mesh_z(abl.z_values, abl.Z_offset, abl.meshCount, in_back, out_back), reprobed, abl.verbose_level);
+                if (reprobed) reprobes++;
+              }
+              else
+            #endif
+                abl.measured_z = faux ? 0.001f * random(-100, 101) : probe.probe_at_point(abl.probePos, raise_after, abl.verbose_level);
 
           #endif
 
@@ -867,6 +939,15 @@ G29_TYPE GcodeSuite::G29() {
       set_bed_leveling_enabled(abl.reenable);
       abl.measured_z = NAN;
     }
+
+    // Probing time, to compare the fast mesh against 'G29 K0'
+    if (!faux) {
+      SERIAL_ECHOPGM("G29 probing ", millis() - g29_start_ms, "ms");
+      #if ENABLED(BLTOUCH_FAST_MESH)
+        if (fast_mesh) SERIAL_ECHOPGM(" (fast, heat wait ", heat_wait_ms, "ms, second probes ", reprobes, "/", abl.abl_points, ")");
+      #endif
+      SERIAL_EOL();
+    }
   }
   #endif // !PROBE_MANUALLY
 
@@ -1103,6 +1184,8 @@ G29_TYPE GcodeSuite::G29() {
 
   report_current_position();
 
+  SERIAL_ECHOLNPGM("G29 total ", millis() - g29_start_ms, "ms");
+
   G29_RETURN(isnan(abl.measured_z), true);
 }
 
@@ -1157,6 +1157,26 @@ void GcodeSuite::process_parsed_command(bool no_ok/*=false*/) {
         case 1004: M1004(); break;                                // M1004: UBL Mesh Wizard
       #endif
 
+      #if ENABLED(DWIN_CREALITY_LCD)
+        case 1010: M1010(); break;                                // M1010: Report DWIN LCD statistics
+      #endif
+
+      #if ENABLED(STEPPER_ISR_PROFILE)
+        case 1011: M1011(); break;                                // M1011: Report Stepper ISR profile
+      #endif
+
+      #if ENABLED(SERIAL_LINK_STATS)
+        case 1012: M1012(); break;                                // M1012: Serial link statistics
+      #endif
+
+      #if ENABLED(PLANNER_STARVATION_PROFILE)
+        case 1013: M1013(); break;                                // M1013: Report planner starvation profile
+      #endif
+
+      #if ENABLED(SDIO_READ_AHEAD)
+        case 1014: M1014(); break;                                // M1014: Report SD read-ahead statistics
+      #endif
+
       #if ENABLED(MAX7219_GCODE)
         case 7219: M7219(); break;                                // M7219: Set LEDs, columns, and rows
       #endif
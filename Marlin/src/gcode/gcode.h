@@ -342,6 +342,11 @@
  * M995 - Touch screen calibration for TFT display
  * M997 - Perform in-application firmware update
  * M999 - Restart after being stopped by error
+ * M1010 - Report DWIN LCD transmit and thumbnail statistics. (Requires DWIN_CREALITY_LCD)
+ * M1011 - Report and reset the Stepper ISR cycle profile. (Requires STEPPER_ISR_PROFILE)
+ * M1012 - Report, auto-report or reset serial link statistics. (Requires SERIAL_LINK_STATS)
+ * M1013 - Report and reset the planner starvation profile. (Requires PLANNER_STARVATION_PROFILE)
+ * M1014 - Report and reset SD card read-ahead statistics. (Requires SDIO_READ_AHEAD)
  *
  * D... - Custom Development G-code. Add hooks to "gcode_D.cpp" for developers to test features. (Requires MARLIN_DEV_MODE)
  *        D576 - Set buffer monitoring options. (Requires BUFFER_MONITORING)
@@ -1360,6 +1365,26 @@ private:
     static void M1004();
   #endif
 
+  #if ENABLED(DWIN_CREALITY_LCD)
+    static void M1010();
+  #endif
+
+  #if ENABLED(STEPPER_ISR_PROFILE)
+    static void M1011();
+  #endif
+
+  #if ENABLED(SERIAL_LINK_STATS)
+    static void M1012();
+  #endif
+
+  #if ENABLED(PLANNER_STARVATION_PROFILE)
+    static void M1013();
+  #endif
+
+  #if ENABLED(SDIO_READ_AHEAD)
+    static void M1014();
+  #endif
+
   #if ENABLED(HAS_MCP3426_ADC)
     static void M3426();
   #endif
@@ -70,6 +70,9 @@ void GcodeSuite::D(const int16_t dcode) {
         const uint8_t value = 0x0;
         while (total--) persistentStore.write_data(pos, &value, 1);
         persistentStore.access_finish();
+        #if ENABLED(EEPROM_ASYNC_COMMIT)
+          while (persistentStore.committing()) { persistentStore.commit_task(); hal.watchdog_refresh(); }
+        #endif
       #else
         settings.reset();
         settings.save();
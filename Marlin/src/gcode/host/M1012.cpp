@@ -0,0 +1,51 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2021 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "../../inc/MarlinConfig.h"
+
+#if ENABLED(SERIAL_LINK_STATS)
+
+#include "../gcode.h"
+#include "../queue.h"
+
+/**
+ * M1012: Report serial link statistics
+ *
+ * Parameters:
+ *   S<seconds>  Auto-report interval, 0 to stop (max 60)
+ *   R           Reset the counters
+ *
+ * Example:
+ *   echo:Serial 1 lines:182210 (212/s) bytes:5120933 (6010/s) resends:3 line errors:1 checksum errors:2 RX high-water:301 overruns:0
+ *   echo:Command queue empty while printing:15420ms
+ *
+ * Rates are since the previous report. Resends with errors point at the link or the
+ * host, overruns at a blocked main loop. Queue time empty with a clean link means the
+ * host isn't sending fast enough; compare with the planner (D576) to find the bottleneck.
+ */
+void GcodeSuite::M1012() {
+  if (parser.seenval('S')) queue.set_link_report_interval(parser.value_byte());
+  if (parser.seen_test('R')) { queue.reset_link_stats(); return; }
+  if (!parser.seen('S')) queue.report_link_stats();
+}
+
+#endif // SERIAL_LINK_STATS
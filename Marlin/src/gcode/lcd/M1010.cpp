@@ -0,0 +1,64 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "../../inc/MarlinConfig.h"
+
+#if ENABLED(DWIN_CREALITY_LCD)
+
+#include "../gcode.h"
+#include "../../lcd/e3v2/creality/dwin_lcd.h"
+#include "../../lcd/e3v2/creality/dwin_thumb.h"
+
+/**
+ * M1010: Report DWIN LCD statistics
+ *
+ * Parameters:
+ *   R  Reset the statistics after reporting
+ *
+ * Example:
+ *   echo:LCD TX queued:48211 high water:612/1023 stalls:0
+ *   echo:LCD fields drawn:212 unchanged:5830 deferred:4
+ *   echo:Thumb rows:96 slices:212 max slice:7940us preview:1830ms max:2410ms index hits:3 misses:2
+ *
+ * "high water" is the most bytes ever waiting in the transmit queue, and
+ * "stalls" counts the times a draw call had to wait for room in it.
+ * "unchanged" counts status field refreshes skipped because the value was
+ * already on screen, and "deferred" those held back by DWIN_LCD_BYTES_PER_SEC.
+ * "preview" is the time from selecting a file to its finished thumbnail.
+ */
+void GcodeSuite::M1010() {
+  SERIAL_ECHO_MSG("LCD TX queued:", dwin_tx.bytes, " high water:", dwin_tx.high_water, "/", DWIN_TX_QUEUE_SIZE - 1, " stalls:", dwin_tx.stalls);
+  SERIAL_ECHO_MSG("LCD fields drawn:", dwin_shadow.drawn, " unchanged:", dwin_shadow.skipped, " deferred:", dwin_shadow.deferred);
+  #if ENABLED(DWIN_RENDER_THUMBNAIL)
+    SERIAL_ECHO_MSG("Thumb rows:", thumb.rows, " slices:", thumb.slices, " max slice:", thumb.slice_max_us, "us"
+                    " preview:", thumb.preview_ms, "ms max:", thumb.preview_max_ms, "ms"
+                    " index hits:", thumb_index.hits, " misses:", thumb_index.misses);
+  #endif
+  if (parser.seen_test('R')) {
+    dwin_tx.reset_stats();
+    dwin_shadow.reset_stats();
+    TERN_(DWIN_RENDER_THUMBNAIL, thumb.reset_stats());
+    TERN_(DWIN_RENDER_THUMBNAIL, thumb_index.hits = thumb_index.misses = 0);
+  }
+}
+
+#endif // DWIN_CREALITY_LCD
@@ -12,6 +12,8 @@
 /*
 *Function Name: gcodeG212()
 *Purpose: Used for the host computer to send test instructions, such as G212 C128 B P T, C128 = measure 128 times; B = perform head wipe operation; P = perform pressure sensor measurement operation; T = perform CR-TOUCH measurement operation
+*         G212 K probes the pressure sensor once and reports the height and time taken; K S probes with Z steps instead of one continuous move
+*         G212 D prints the samples of the last pressure probe (after K: of that probe) as CSV for offline replay
 *Params: None
 *Return: None
 */
@@ -25,6 +27,7 @@ void GcodeSuite::G212()
     HX711 hx711;
     hx711.init(HX711_SCK_PIN, HX711_SDO_PIN);
     FOR_LOOP_TIMES(i, 0, count, hx711.getVal(1)); 
+    SERIAL_ECHOLNPGM("HX711 samples:", HX711::samples, " overruns:", HX711::overruns);
     return;
   }
 
@@ -42,7 +45,16 @@ void GcodeSuite::G212()
     pa.step_mm = 0.02;  //Rock             
     pa.minHold = MIN_HOLD;
     pa.maxHold = MAX_HOLD;
-    pa.probePointByStep();
+    const millis_t ms = millis();
+    TERN(AUTOZ_PROBE_BY_MOVE, (GET_PARSER_SEEN('S') ? pa.probePointByStep() : pa.probePointByMove()), pa.probePointByStep());
+    SERIAL_ECHOLNPGM("Probe Z:", pa.outVal_mm, " index:", pa.outIndex, " time:", millis() - ms, "ms");
+    if(GET_PARSER_SEEN('D')) ProbeTrace::dump();
+    return;
+  }
+
+  if(GET_PARSER_SEEN('D'))
+  {
+    ProbeTrace::dump();
     return;
   }
 
@@ -45,6 +45,10 @@ GCodeQueue queue;
   #include "../feature/powerloss.h"
 #endif
 
+#if ENABLED(PLANNER_STARVATION_PROFILE)
+  #include "../feature/starvation.h"
+#endif
+
 #if ENABLED(GCODE_REPEAT_MARKERS)
   #include "../feature/repeat.h"
 #endif
@@ -76,6 +80,18 @@ GCodeQueue::RingBuffer GCodeQueue::ring_buffer = { 0 };
   millis_t GCodeQueue::next_buffer_report_ms;
 #endif
 
+#if ENABLED(SERIAL_LINK_STATS)
+  millis_t GCodeQueue::starved_ms, GCodeQueue::starved_at, GCodeQueue::link_report_ms;
+  uint32_t GCodeQueue::last_lines[NUM_SERIAL], GCodeQueue::last_bytes[NUM_SERIAL];
+  uint8_t GCodeQueue::link_report_interval;
+  millis_t GCodeQueue::next_link_report_ms;
+
+  // The STM32 HAL counts bytes lost to a full RX buffer on its hardware serial port
+  #if defined(HAL_STM32) && DISABLED(SERIAL_DMA) && !HAS_MULTI_SERIAL && SERIAL_PORT >= 0
+    #define HAS_RX_DROP_COUNT 1
+  #endif
+#endif
+
 /**
  * Serial command injection
  */
@@ -278,6 +294,9 @@ void GCodeQueue::flush_and_request_resend(const serial_index_t serial_ind) {
 
 static bool serial_data_available(serial_index_t index) {
   const int a = SERIAL_IMPL.available(index);
+  #if ENABLED(SERIAL_LINK_STATS)
+    NOLESS(GCodeQueue::serial_state[index.index].stats.rx_high_water, a);
+  #endif
   #if ENABLED(RX_BUFFER_MONITOR) && RX_BUFFER_SIZE
     if (a > RX_BUFFER_SIZE - 2) {
       PORT_REDIRECT(SERIAL_PORTMASK(index));
@@ -323,6 +342,7 @@ void GCodeQueue::gcode_line_error(FSTR_P const ferr, const serial_index_t serial
   SERIAL_ECHOLN(ferr, serial_state[serial_ind.index].last_N);
   while (read_serial(serial_ind) != -1) { /* nada */ } // Clear out the RX buffer. Why don't use flush here ?
   flush_and_request_resend(serial_ind);
+  TERN_(SERIAL_LINK_STATS, serial_state[serial_ind.index].stats.resends++);
   serial_state[serial_ind.index].count = 0;
 }
 
@@ -460,6 +480,7 @@ void GCodeQueue::get_serial_commands() {
 
       const char serial_char = (char)c;
       SerialState &serial = serial_state[p];
+      TERN_(SERIAL_LINK_STATS, serial.stats.bytes++);
 
       if (ISEOL(serial_char)) {
 
@@ -488,6 +509,7 @@ void GCodeQueue::get_serial_commands() {
             // A request-for-resend line was already in transit so we got two - oops!
             if (WITHIN(gcode_N, serial.last_N - 1, serial.last_N)) continue;
             // A corrupted line or too high, indicating a lost line
+            TERN_(SERIAL_LINK_STATS, serial.stats.line_errors++);
             gcode_line_error(F(STR_ERR_LINE_NO), p);
             break;
           }
@@ -497,11 +519,13 @@ void GCodeQueue::get_serial_commands() {
             uint8_t checksum = 0, count = uint8_t(apos - command);
             while (count) checksum ^= command[--count];
             if (strtol(apos + 1, nullptr, 10) != checksum) {
+              TERN_(SERIAL_LINK_STATS, serial.stats.checksum_errors++);
               gcode_line_error(F(STR_ERR_CHECKSUM_MISMATCH), p);
               break;
             }
           }
           else {
+            TERN_(SERIAL_LINK_STATS, serial.stats.checksum_errors++);
             gcode_line_error(F(STR_ERR_NO_CHECKSUM), p);
             break;
           }
@@ -550,6 +574,7 @@ void GCodeQueue::get_serial_commands() {
 
         // Add the command to the queue
         ring_buffer.enqueue(serial.line_buffer, false OPTARG(HAS_MULTI_SERIAL, p));
+        TERN_(SERIAL_LINK_STATS, serial.stats.lines++);
       }
       else
         process_stream_char(serial_char, serial.input_state, serial.line_buffer, serial.count);
@@ -574,12 +599,17 @@ void GCodeQueue::get_serial_commands() {
 
     int sd_count = 0;
     while (!ring_buffer.full() && !card.eof()) {
-      const int16_t n = card.get();
+      // Take everything up to the next EOL from the read-ahead buffer at once
+      uint16_t len;
+      const char * const span = card.getSpan(len);
+      if (!span) { SERIAL_ERROR_MSG(STR_SD_ERR_READ); continue; }
       const bool card_eof = card.eof();
-      if (n < 0 && !card_eof) { SERIAL_ERROR_MSG(STR_SD_ERR_READ); continue; }
 
       CommandLine &command = ring_buffer.commands[ring_buffer.index_w];
-      const char sd_char = (char)n;
+      for (uint16_t i = 0; i < len - 1; i++)
+        process_stream_char(span[i], sd_input_state, command.buffer, sd_count);
+
+      const char sd_char = span[len - 1];
       const bool is_eol = ISEOL(sd_char);
       if (is_eol || card_eof) {
 
@@ -640,6 +670,8 @@ void GCodeQueue::exhaust() {
  */
 void GCodeQueue::advance() {
 
+  TERN_(PLANNER_STARVATION_PROFILE, starvation_profile.update());
+
   // Process immediate commands
   if (process_injected_command_P() || process_injected_command()) return;
 
@@ -742,3 +774,55 @@ void GCodeQueue::advance() {
   }
 
 #endif // BUFFER_MONITORING
+
+#if ENABLED(SERIAL_LINK_STATS)
+
+  void GCodeQueue::report_link_stats() {
+    const millis_t ms = millis(), span = _MAX(ms - link_report_ms, 1UL);
+    for (uint8_t p = 0; p < NUM_SERIAL; ++p) {
+      const LinkStats &s = serial_state[p].stats;
+      SERIAL_ECHOPGM("Serial ", p + 1,
+        " lines:", s.lines, " (", uint32_t(uint64_t(s.lines - last_lines[p]) * 1000UL / span), "/s)"
+        " bytes:", s.bytes, " (", uint32_t(uint64_t(s.bytes - last_bytes[p]) * 1000UL / span), "/s)"
+        " resends:", s.resends, " line errors:", s.line_errors, " checksum errors:", s.checksum_errors,
+        " RX high-water:", s.rx_high_water
+      );
+      TERN_(HAS_RX_DROP_COUNT, SERIAL_ECHOPGM(" overruns:", MYSERIAL1.dropped()));
+      SERIAL_EOL();
+      last_lines[p] = s.lines;
+      last_bytes[p] = s.bytes;
+    }
+    SERIAL_ECHOLNPGM("Command queue empty while printing:", starved_ms + (starved_at ? ms - starved_at : 0), "ms");
+    link_report_ms = ms;
+  }
+
+  void GCodeQueue::reset_link_stats() {
+    for (uint8_t p = 0; p < NUM_SERIAL; ++p) {
+      serial_state[p].stats = {};
+      last_lines[p] = last_bytes[p] = 0;
+    }
+    TERN_(HAS_RX_DROP_COUNT, MYSERIAL1.rx_dropped_bytes = 0);
+    starved_ms = 0;
+    if (starved_at) starved_at = millis();
+    link_report_ms = millis();
+  }
+
+  void GCodeQueue::auto_report_link_stats() {
+    // "Printing" includes a host streaming moves without a print job
+    const millis_t ms = millis();
+    const bool starved = ring_buffer.empty() && (printingIsActive() || planner.has_blocks_queued());
+    if (starved_at) {
+      if (!starved) { starved_ms += ms - starved_at; starved_at = 0; }
+    }
+    else if (starved)
+      starved_at = ms;
+
+    if (link_report_interval && ELAPSED(ms, next_link_report_ms)) {
+      next_link_report_ms = ms + 1000UL * link_report_interval;
+      PORT_REDIRECT(SerialMask::All);
+      report_link_stats();
+      PORT_RESTORE();
+    }
+  }
+
+#endif // SERIAL_LINK_STATS
@@ -33,6 +33,20 @@ public:
   /**
    * The buffers per serial port.
    */
+  #if ENABLED(SERIAL_LINK_STATS)
+    /**
+     * Serial link health counters, since boot or M1012 R
+     */
+    struct LinkStats {
+      uint32_t lines,               //!< Lines queued from this port
+               bytes;               //!< Bytes read from this port
+      uint16_t resends,             //!< Resend requests sent by gcode_line_error()
+               line_errors,         //!< Lines out of sequence
+               checksum_errors,     //!< Lines with a bad or missing checksum
+               rx_high_water;       //!< Most bytes found waiting in the RX buffer
+    };
+  #endif
+
   struct SerialState {
     /**
      * G-Code line number handling. Hosts may include line numbers when sending
@@ -43,6 +57,9 @@ public:
     int count;                      //!< Number of characters read in the current line of serial input
     char line_buffer[MAX_CMD_SIZE]; //!< The current line accumulator
     uint8_t input_state;            //!< The input state
+    #if ENABLED(SERIAL_LINK_STATS)
+      LinkStats stats;              //!< Link health counters
+    #endif
   };
 
   static SerialState serial_state[NUM_SERIAL]; //!< Serial states for each serial port
@@ -259,6 +276,38 @@ public:
 
   #endif // BUFFER_MONITORING
 
+  #if ENABLED(SERIAL_LINK_STATS)
+
+    private:
+
+    static millis_t starved_ms,           // Time the command ring was empty while printing
+                    starved_at,           // When it last ran dry, or 0
+                    link_report_ms;       // Time of the last report, for the rates
+    static uint32_t last_lines[NUM_SERIAL], last_bytes[NUM_SERIAL];
+    static uint8_t link_report_interval;
+    static millis_t next_link_report_ms;
+
+    public:
+
+    /**
+     * Report link statistics for each serial port: totals, rates since the
+     * last report, resends and errors, RX buffer high-water mark and overruns,
+     * and the time the command ring ran dry while printing
+     */
+    static void report_link_stats();
+    static void reset_link_stats();
+
+    // Track command ring starvation and send the auto-report
+    static void auto_report_link_stats();
+
+    static void set_link_report_interval(uint8_t v) {
+      NOMORE(v, 60);
+      link_report_interval = v;
+      next_link_report_ms = millis() + 1000UL * v;
+    }
+
+  #endif // SERIAL_LINK_STATS
+
 private:
 
   static void get_serial_commands();
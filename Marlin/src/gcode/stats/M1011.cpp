@@ -0,0 +1,53 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "../../inc/MarlinConfig.h"
+
+#if ENABLED(STEPPER_ISR_PROFILE)
+
+#include "../gcode.h"
+#include "../../feature/stepper_profile.h"
+
+/**
+ * M1011: Report the Stepper ISR profile
+ *
+ * Parameters:
+ *   R  Reset the profile after reporting
+ *
+ * Example:
+ *   echo:Stepper ISR load:31.6% over 20000ms calls:412330 rate:20616/s late:12 catch-up:40
+ *   echo:isr n:412330 min:212 avg:1290 max:6120 cyc (72us) hist: 0,1811,40210,352870,17300,139,0,0
+ *   echo:pulse n:398112 min:96 avg:310 max:880 cyc (10us) hist: 51020,340210,6882,0,0,0,0,0
+ *   echo:block n:398112 min:88 avg:640 max:5410 cyc (64us) hist: ...
+ *   echo:Multistep up:22 down:21 levels: x1:398012 x2:13200 x4:1118 x8:0 x16:0 blocks:8110 smoothed:6230
+ *
+ * Cycles are DWT cycles of F_CPU. Histogram bins are <256, <512, <1K ... cycles, the last holding the rest.
+ * "late" counts ISRs that overran the next step time, "catch-up" the extra passes to run events already due.
+ * "levels" is how many ISRs ran at each multi-stepping factor, "smoothed" the blocks with step smoothing.
+ * Keep the "isr" load and max well below 100% / the shortest step interval at the highest feedrate.
+ */
+void GcodeSuite::M1011() {
+  stepper_profile.report();
+  if (parser.seen_test('R')) stepper_profile.reset();
+}
+
+#endif // STEPPER_ISR_PROFILE
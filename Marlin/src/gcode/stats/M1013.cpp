@@ -0,0 +1,52 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "../../inc/MarlinConfig.h"
+
+#if ENABLED(PLANNER_STARVATION_PROFILE)
+
+#include "../gcode.h"
+#include "../../feature/starvation.h"
+
+/**
+ * M1013: Report the planner starvation profile
+ *
+ * Parameters:
+ *   R  Reset the profile after reporting
+ *
+ * Example:
+ *   echo:Planner underruns:4 idle:1830ms longest:912ms over 3620400ms avg depth:27.5/32
+ *   echo:depth %: 0,1,1,2,3,6,21,66
+ *   echo:underrun at 1204311ms file:3918204 after 0.18mm at 120.0mm/s idle:912ms
+ *
+ * Depth is the share of main loop passes while printing with the planner in each
+ * eighth of BLOCK_BUFFER_SIZE, emptiest first. An underrun is the stepper running
+ * out of blocks mid-print; "file" is the media read position at the time, and the
+ * length and speed are of the last block it ran. Short fast segments with a deep
+ * planner point at the planner; a shallow planner points at the transport.
+ */
+void GcodeSuite::M1013() {
+  starvation_profile.report();
+  if (parser.seen_test('R')) starvation_profile.reset();
+}
+
+#endif // PLANNER_STARVATION_PROFILE
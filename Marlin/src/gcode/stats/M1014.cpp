@@ -0,0 +1,51 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "../../inc/MarlinConfig.h"
+
+#if ENABLED(SDIO_READ_AHEAD)
+
+#include "../gcode.h"
+#include "../../sd/cardreader.h"
+
+/**
+ * M1014: Report SD card read-ahead statistics
+ *
+ * Parameters:
+ *   R  Reset the counters after reporting
+ *
+ * Example:
+ *   echo:SD blocks read:20488 ahead:20310 direct:178 stalls:12 written:0 errors:0
+ *   echo:SD card sustained:3912KB/s read:9KB/s waited:310ms over 1180200ms
+ *
+ * "Sustained" is the card's rate while a read-ahead transfer is in flight,
+ * "read" is the rate blocks were consumed over the whole span. A stall is a
+ * read that caught up with the transfer filling its buffer; "waited" is all
+ * time spent blocked on the card, including on-demand (direct) reads.
+ * "Written" counts blocks sent with CMD25 by a streaming upload.
+ */
+void GcodeSuite::M1014() {
+  card.media_driver_sdcard.report_stats();
+  if (parser.seen_test('R')) card.media_driver_sdcard.reset_stats();
+}
+
+#endif // SDIO_READ_AHEAD
@@ -80,6 +80,11 @@
   #undef OTA_FIRMWARE_UPDATE
 #endif
 
+// The background commit is part of the STM32 IIC_BL24CXX_EEPROM store
+#if ENABLED(EEPROM_ASYNC_COMMIT) && !(defined(HAL_STM32) && ENABLED(IIC_BL24CXX_EEPROM))
+  #undef EEPROM_ASYNC_COMMIT
+#endif
+
 /**
  * Axis lengths and center
  */
@@ -595,6 +600,11 @@
 
 #endif // HAS_MEDIA
 
+// The SDIO read-ahead is part of the onboard SDIO driver
+#if ENABLED(SDIO_READ_AHEAD) && !NEED_SD2CARD_SDIO
+  #undef SDIO_READ_AHEAD
+#endif
+
 /**
  * Power Supply
  */
@@ -2826,7 +2836,7 @@
 #if !HAS_TEMP_SENSOR
   #undef AUTO_REPORT_TEMPERATURES
 #endif
-#if ANY(AUTO_REPORT_TEMPERATURES, AUTO_REPORT_SD_STATUS, AUTO_REPORT_POSITION, AUTO_REPORT_FANS)
+#if ANY(AUTO_REPORT_TEMPERATURES, AUTO_REPORT_SD_STATUS, AUTO_REPORT_POSITION, AUTO_REPORT_FANS, SERIAL_LINK_STATS)
   #define HAS_AUTO_REPORTING 1
 #endif
 
@@ -1395,6 +1395,16 @@ static_assert(NUM_SERVOS <= NUM_SERVO_PLUGS, "NUM_SERVOS (or some servo index) i
       #endif
     #endif
 
+    #if ENABLED(BLTOUCH_FAST_MESH)
+      #if !HAS_BLTOUCH_HS_MODE
+        #error "BLTOUCH_FAST_MESH requires BLTOUCH_HS_MODE."
+      #elif DISABLED(AUTO_BED_LEVELING_BILINEAR)
+        #error "BLTOUCH_FAST_MESH requires AUTO_BED_LEVELING_BILINEAR."
+      #endif
+      static_assert(BLTOUCH_FAST_MESH_TOLERANCE > 0, "BLTOUCH_FAST_MESH_TOLERANCE must be greater than 0.");
+      static_assert(BLTOUCH_FAST_MESH_LIFT >= 0, "BLTOUCH_FAST_MESH_LIFT must be 0 or more.");
+    #endif
+
     #if BLTOUCH_DELAY < 200
       #error "BLTOUCH_DELAY less than 200 is unsafe and is not supported."
     #endif
@@ -2788,6 +2798,60 @@ static_assert(NUM_SERVOS <= NUM_SERVO_PLUGS, "NUM_SERVOS (or some servo index) i
   #endif
 #endif
 
+/**
+ * Stepper ISR Profile reads the DWT cycle counter
+ */
+#if ENABLED(STEPPER_ISR_PROFILE) && !(defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__))
+  #error "STEPPER_ISR_PROFILE requires an ARM Cortex-M3, M4, or M7."
+#endif
+
+#if ENABLED(MOTION_BENCHMARK) && !defined(__PLAT_LINUX__)
+  #error "MOTION_BENCHMARK is only for the native (Linux) unit test build."
+#endif
+
+/**
+ * SDIO read-ahead streams with the STM32 SDIO driver
+ */
+#if ENABLED(SDIO_READ_AHEAD)
+  #ifndef HAL_STM32
+    #error "SDIO_READ_AHEAD requires an STM32 (HAL/STM32) board."
+  #elif !WITHIN(SDIO_READ_AHEAD_BLOCKS, 2, 16)
+    #error "SDIO_READ_AHEAD_BLOCKS must be from 2 to 16."
+  #endif
+#endif
+
+#if ENABLED(POWER_LOSS_JOURNAL)
+  #if DISABLED(POWER_LOSS_RECOVERY)
+    #error "POWER_LOSS_JOURNAL requires POWER_LOSS_RECOVERY."
+  #elif !WITHIN(POWER_LOSS_JOURNAL_BLOCKS, 4, 1024)
+    #error "POWER_LOSS_JOURNAL_BLOCKS must be from 4 to 1024."
+  #elif POWER_LOSS_JOURNAL_MS < 0
+    #error "POWER_LOSS_JOURNAL_MS must be 0 or more."
+  #endif
+#endif
+
+#if ENABLED(BINARY_STREAM_UPLOAD)
+  #if DISABLED(BINARY_FILE_TRANSFER)
+    #error "BINARY_STREAM_UPLOAD requires BINARY_FILE_TRANSFER."
+  #elif !WITHIN(BINARY_STREAM_WINDOW, 1, 16)
+    #error "BINARY_STREAM_WINDOW must be from 1 to 16."
+  #elif !WITHIN(BINARY_STREAM_PACKET_SIZE, 64, 2048)
+    #error "BINARY_STREAM_PACKET_SIZE must be from 64 to 2048."
+  #endif
+#endif
+
+#if ENABLED(SD_EXTENT_MAP) && !WITHIN(SD_EXTENT_MAP_SIZE, 1, 255)
+  #error "SD_EXTENT_MAP_SIZE must be from 1 to 255."
+#endif
+
+#if ENABLED(SD_DIR_INDEX)
+  #if !WITHIN(SD_DIR_INDEX_SIZE, 16, 4096)
+    #error "SD_DIR_INDEX_SIZE must be from 16 to 4096."
+  #elif !WITHIN(SD_DIR_INDEX_NAMES, 4, 64)
+    #error "SD_DIR_INDEX_NAMES must be from 4 to 64."
+  #endif
+#endif
+
 /**
  * Make sure features that need to write to the SD card can
  */
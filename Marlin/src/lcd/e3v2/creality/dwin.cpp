@@ -26,6 +26,7 @@ lin 3D Printer Firmware
 #include "../../../inc/MarlinConfig.h"
 #if ENABLED(DWIN_CREALITY_LCD)
 #include "dwin.h"
+#include "dwin_thumb.h"
 #include "ui_position.h" //Ui position
 #if ANY(AUTO_BED_LEVELING_BILINEAR, AUTO_BED_LEVELING_LINEAR, AUTO_BED_LEVELING_3POINT) && DISABLED(PROBE_MANUALLY)
 #define HAS_ONESTEP_LEVELING 1
@@ -68,6 +69,10 @@ lin 3D Printer Firmware
 #include "../../../feature/powerloss.h"
 #endif
 
+#if ENABLED(PLANNER_STARVATION_PROFILE)
+#include "../../../feature/starvation.h"
+#endif
+
 #include "../../../module/AutoOffset.h"
 
 // #include <QRCodeGenerator.h>
@@ -115,6 +120,7 @@ lin 3D Printer Firmware
 #define HEAT_ANIMATION_FLASH 150                   // Heating animation refresh
 #define DWIN_SCROLL_UPDATE_INTERVAL SEC_TO_MS(0.5) // Rock 20210819
 #define DWIN_REMAIN_TIME_UPDATE_INTERVAL SEC_TO_MS(20)
+#define DWIN_SHADOW_KEYFRAME_INTERVAL SEC_TO_MS(10)   // Redraw every status field now and then, even if unchanged
 
 #define PRINT_SET_OFFSET 4 // Rock 20211115
 #define TEMP_SET_OFFSET 2  // Rock 20211115
@@ -398,7 +404,7 @@ static void Auto_in_out_feedstock(bool dir) // 0 returns material, 1 feeds
     if( preheat_flag && thermalManager.degHotend(0) >= ui.material_preset[material].hotend_temp && thermalManager.degBed() >= ui.material_preset[material].bed_temp){
       // beep to alert process finished
       Generic_BeepAlert();
-      delay(200);
+      DWIN_Delay(200);
       Generic_BeepAlert();
       preheat_flag = false;
     }
@@ -421,12 +427,12 @@ static void Auto_in_out_feedstock(bool dir) // 0 returns material, 1 feeds
       SET_HOTEND_TEMP(temp, 0);           // First heat to Target Temp
       WAIT_HOTEND_TEMP(60 * 5 * 1000, 3); // Wait until the hotend temperature reaches the target temperature
 
-      delay(1000);                                                                          // Wait for 1s
+      DWIN_Delay(1000);                                                                     // Wait for 1s
       Clear_Title_Bar();                                                                    // Clear title bar
       DWIN_Draw_String(false, false, DWIN_FONT_HEAD, Color_Red, Color_Bg_Blue, 10, 4, str); // Draw title
 
       In_out_feedtock(length, FEEDING_DEF_SPEED, true);                        // Feed material
-      delay(1000);                                                             // Wait for 1s
+      DWIN_Delay(1000);                                                        // Wait for 1s
       Clear_Title_Bar();                                                       // Clear title bar
       Popup_Window_Feedstork_Finish(1);                                        // Feed confirmation
       DWIN_ICON_Not_Filter_Show(HMI_flag.language, LANGUAGE_Confirm, 79, 264); // OK button
@@ -481,9 +487,12 @@ static void Read_Boot_Step_Value()
   // SERIAL_ECHOLNPGM(" >>> Read_Boot_Step_Value");
 #if ENABLED(EEPROM_SETTINGS) && ENABLED(IIC_BL24CXX_EEPROM)
   // First read the value of hmi flag.boot step to determine whether booting is required.
-  BL24CXX::read(DWIN_BOOT_STEP_EEPROM_ADDRESS, (uint8_t *)&HMI_flag.boot_step, sizeof(HMI_flag.boot_step));
+  // If the EEPROM doesn't answer, don't send the user through the boot guide again.
+  if (!BL24CXX::read(DWIN_BOOT_STEP_EEPROM_ADDRESS, (uint8_t *)&HMI_flag.boot_step, sizeof(HMI_flag.boot_step)))
+    HMI_flag.boot_step = Boot_Step_Max;
   // Read language configuration items
-  BL24CXX::read(DWIN_LANGUAGE_EEPROM_ADDRESS, (uint8_t *)&HMI_flag.language, sizeof(HMI_flag.language));
+  if (!BL24CXX::read(DWIN_LANGUAGE_EEPROM_ADDRESS, (uint8_t *)&HMI_flag.language, sizeof(HMI_flag.language)))
+    HMI_flag.language = English;
 #endif
   // SERIAL_ECHOLNPGM(" HMI_flag.boot_step: ", HMI_flag.boot_step);
   // SERIAL_ECHOLNPGM(" HMI_flag.language: ", HMI_flag.language);
@@ -994,7 +1003,7 @@ void Clear_Title_Bar()
   DWIN_Draw_Rectangle(1, Color_Bg_Blue, 0, 0, DWIN_WIDTH, 30);
 #elif ENABLED(DWIN_CREALITY_320_LCD)
   DWIN_Draw_Rectangle(1, Color_Bg_Blue, 0, 0, DWIN_WIDTH - 1, 24);
-  delay(2);
+  DWIN_Delay(2);
 #endif
 }
 
@@ -1052,7 +1061,7 @@ void Clear_Menu_Area()
     DWIN_Draw_Rectangle(1, Color_Bg_Black, 0, 25, DWIN_WIDTH, STATUS_Y - 1);
   }
 #endif
-  delay(2);
+  DWIN_Delay(2);
 }
 
 void Clear_Main_Window()
@@ -1086,7 +1095,7 @@ void Draw_Popup_Bkgd_105()
 #elif ENABLED(DWIN_CREALITY_320_LCD)
   DWIN_Draw_Rectangle(1, Color_Bg_Window, 8, 30, 232, 240);
 #endif
-  delay(2);
+  DWIN_Delay(2);
 }
 
 
@@ -2566,11 +2575,11 @@ void DWIN_Popup_Temperature(const bool toohigh, int8_t Error_id)
   if (toohigh)
   {
     DWIN_ICON_Show(ICON, ICON_TempTooHigh, 102, 165);
-    delay(2);
+    DWIN_Delay(2);
     if (HMI_flag.language < Language_Max)
     {
       DWIN_ICON_Show(HMI_flag.language, LANGUAGE_TempHigh, 14, 222);
-      delay(2);
+      DWIN_Delay(2);
     }
     else
     {
@@ -2581,24 +2590,24 @@ void DWIN_Popup_Temperature(const bool toohigh, int8_t Error_id)
   else
   {
     DWIN_ICON_Show(ICON, ICON_TempTooLow, 102, 165);
-    delay(2);
+    DWIN_Delay(2);
     if (HMI_flag.language < Language_Max)
     {
       DWIN_ICON_Show(HMI_flag.language, LANGUAGE_TempLow, 14, 222);
-      delay(5);
+      DWIN_Delay(5);
     }
   }
 #elif ENABLED(DWIN_CREALITY_320_LCD)
   if (toohigh) // too high
   {
     DWIN_ICON_Show(ICON, ICON_TempTooHigh, 82, 45);
-    delay(5);
+    DWIN_Delay(5);
     if (Error_id) // hot bed
     {
       if (HMI_flag.language < Language_Max)
       {
         DWIN_ICON_Show(HMI_flag.language, LANGUAGE_Bed_HIGH, 14, 134);
-        delay(5);
+        DWIN_Delay(5);
       }
     }
     else // nozzle
@@ -2606,20 +2615,20 @@ void DWIN_Popup_Temperature(const bool toohigh, int8_t Error_id)
       if (HMI_flag.language < Language_Max)
       {
         DWIN_ICON_Show(HMI_flag.language, LANGUAGE_TempHigh, 14, 134);
-        delay(5);
+        DWIN_Delay(5);
       }
     }
   }
   else // too low
   {
     DWIN_ICON_Show(ICON, ICON_TempTooLow, 82, 45);
-    delay(2);
+    DWIN_Delay(2);
     if (Error_id) // hot bed
     {
       if (HMI_flag.language < Language_Max)
       {
         DWIN_ICON_Show(HMI_flag.language, LANGUAGE_Bed_LOW, 14, 134);
-        delay(5);
+        DWIN_Delay(5);
       }
     }
     else // nozzle
@@ -2627,7 +2636,7 @@ void DWIN_Popup_Temperature(const bool toohigh, int8_t Error_id)
       if (HMI_flag.language < Language_Max)
       {
         DWIN_ICON_Show(HMI_flag.language, LANGUAGE_TempLow, 14, 134);
-        delay(5);
+        DWIN_Delay(5);
       }
     }
   }
@@ -2654,13 +2663,13 @@ void Popup_Window_ETempTooLow()
 
 #elif ENABLED(DWIN_CREALITY_320_LCD)
   DWIN_ICON_Not_Filter_Show(ICON, ICON_TempTooLow, 94, 44);
-  delay(2);
+  DWIN_Delay(2);
   if (HMI_flag.language < Language_Max)
   {
     DWIN_ICON_Show(HMI_flag.language, LANGUAGE_TempLow, 14, 136);
-    delay(2);
+    DWIN_Delay(2);
     DWIN_ICON_Not_Filter_Show(HMI_flag.language, LANGUAGE_Confirm, 79, 194);
-    delay(2);
+    DWIN_Delay(2);
   }
 #endif
 }
@@ -2730,9 +2739,9 @@ void Leveling_Error()
     DWIN_ICON_Show(HMI_flag.language, LANGUAGE_LEVEL_ERROR, WORD_LEVELING_ERR_X, WORD_LEVELING_ERR_Y);
     //  DWIN_ICON_Show(HMI_flag.language, LANGUAGE_TempHigh, 14, 134);
   }
-  delay(2);
+  DWIN_Delay(2);
   DWIN_ICON_Not_Filter_Show(ICON, ICON_LEVELING_ERR, ICON_LEVELING_ERR_X, ICON_LEVELING_ERR_Y);
-  delay(2);
+  DWIN_Delay(2);
 }
 // 参数：state:
 // enum Auto_Hight_Stage:uint8_t{Nozz_Start,Nozz_Hot,Nozz_Clear,Nozz_Hight,Nozz_Finish};
@@ -2987,7 +2996,7 @@ void Refresh_Leveling_Value() // Refresh leveling values
     for (Grid_Count.y = 0; Grid_Count.y < GRID_MAX_POINTS_Y; Grid_Count.y++)
     {
       Draw_Dots_On_Screen(&Grid_Count, 0, 0);
-      delay(20); // This parameter must be present, otherwise the refresh will be abnormal.
+      DWIN_Delay(20); // This parameter must be present, otherwise the refresh will be abnormal.
     }
   }
 }
@@ -3249,6 +3258,43 @@ void Draw_Printing_Screen()
 #endif
 }
 
+// Status fields tracked by dwin_shadow
+enum StatusField : uint8_t {
+  SF_PROGRESS,
+  SF_ELAPSED_H, SF_ELAPSED_M,
+  SF_REMAIN_H, SF_REMAIN_M,
+  SF_HOTEND_ICON, SF_HOTEND_TEMP, SF_HOTEND_TARGET, SF_FLOW,
+  SF_BED_ICON, SF_BED_TEMP, SF_BED_TARGET,
+  SF_FEEDRATE, SF_FAN, SF_ZOFFSET
+};
+
+// Offer a new value for a status field at x,y of w x h. True if it has to be drawn now.
+static bool Status_Changed(const StatusField f, const int32_t v, const uint16_t x, const uint16_t y, const uint16_t w, const uint16_t h)
+{
+  return dwin_shadow.update(f, v, x, y, x + w - 1, y + h - 1, dwin_tx.bytes, millis());
+}
+
+// Draw a two digit, zero-filled time field, sending only the digits that changed.
+// Returns the number of digits drawn.
+static uint8_t Draw_Time_Digits(const StatusField f, const uint16_t x, const uint16_t y, const uint16_t value)
+{
+  const bool full = !dwin_shadow.is_valid(f);
+  const int32_t was = dwin_shadow.value(f);
+  if (!Status_Changed(f, value, x, y, 2 * 8, 16)) return 0;
+  const uint8_t n = full ? 2 : DWINShadow::changed_digits(was, value, 2);
+  DWIN_Draw_IntValue(true, true, 1, font8x16, Color_White, Color_Bg_Black, n, x + (2 - n) * 8, y, n == 2 ? value : value % 10);
+  return n;
+}
+
+// Draw "hh:mm" with the colon at cx,cy. The minutes' first digit paints over the colon.
+static void Draw_Time_Value(const StatusField f_hours, const uint16_t x, const uint16_t y, const uint16_t cx, const uint16_t cy, const uint32_t seconds)
+{
+  const uint8_t nh = Draw_Time_Digits(f_hours, x, y, seconds / 3600),
+                nm = Draw_Time_Digits(StatusField(f_hours + 1), x + 24, y, (seconds % 3600) / 60);
+  if (nh == 2 || nm == 2)
+    DWIN_Draw_String(false, false, font8x16, Color_White, Color_Bg_Black, cx, cy, F(":"));
+}
+
 void Draw_Print_ProgressBar()
 {
 // DWIN_ICON_Not_Filter_Show(ICON, ICON_Bar, 15, 98);
@@ -3259,15 +3305,20 @@ void Draw_Print_ProgressBar()
   DWIN_Draw_IntValue(true, true, 0, font8x16, Percent_Color, Color_Bg_Black, 3, 109, 133, ui.get_progress_percent());
   DWIN_Draw_String(false, false, font8x16, Percent_Color, Color_Bg_Black, 133 + 15, 133 - 3, F("%")); // Rock 20220728
 #elif ENABLED(DWIN_CREALITY_320_LCD)
+  const uint8_t percent = ui.get_progress_percent();
+  // The icon's corner stands for the whole icon. Fills that reach it force a redraw.
   #if ENABLED(DWIN_RENDER_THUMBNAIL)
     if(hasThumbnail)
     {
-      DWIN_ICON_Not_Filter_Show(Background_ICON, BG_PRINTING_CIRCLE_MIN + ui.get_progress_percent(), 125, 27);
+      if (Status_Changed(SF_PROGRESS, percent, 125, 27, 1, 1))
+        DWIN_ICON_Not_Filter_Show(Background_ICON, BG_PRINTING_CIRCLE_MIN + percent, 125, 27);
     }else{
-      DWIN_ICON_Not_Filter_Show(Background_ICON, BG_PRINTING_CIRCLE_MIN + ui.get_progress_percent(), ICON_PERCENT_X, ICON_PERCENT_Y);
+      if (Status_Changed(SF_PROGRESS, percent, ICON_PERCENT_X, ICON_PERCENT_Y, 1, 1))
+        DWIN_ICON_Not_Filter_Show(Background_ICON, BG_PRINTING_CIRCLE_MIN + percent, ICON_PERCENT_X, ICON_PERCENT_Y);
     }
   #else
-    DWIN_ICON_Not_Filter_Show(Background_ICON, BG_PRINTING_CIRCLE_MIN + ui.get_progress_percent(), ICON_PERCENT_X, ICON_PERCENT_Y);
+    if (Status_Changed(SF_PROGRESS, percent, ICON_PERCENT_X, ICON_PERCENT_Y, 1, 1))
+      DWIN_ICON_Not_Filter_Show(Background_ICON, BG_PRINTING_CIRCLE_MIN + percent, ICON_PERCENT_X, ICON_PERCENT_Y);
     // DWIN_Draw_IntValue(true, true, 0, font8x16, Percent_Color, Color_Bg_Black, 3, NUM_PRECENT_X, NUM_PRECENT_Y, ui.get_progress_percent());
     // DWIN_Draw_String(false, false, font8x16, Percent_Color, Color_Bg_Black, PRECENT_X, PRECENT_Y, F("%"));
   #endif
@@ -3288,9 +3339,7 @@ void Draw_Print_ProgressElapsed()
     {
       Clear_Print_Time();
     }
-    DWIN_Draw_IntValue(true, true, 1, font8x16, Color_White, Color_Bg_Black, 2, 42, 212 + 3, elapsed.value / 3600);
-    DWIN_Draw_IntValue(true, true, 1, font8x16, Color_White, Color_Bg_Black, 2, 66, 212 + 3, (elapsed.value % 3600) / 60);
-    DWIN_Draw_String(false, false, font8x16, Color_White, Color_Bg_Black, 58 + 6, 211, F(":"));
+    Draw_Time_Value(SF_ELAPSED_H, 42, 212 + 3, 58 + 6, 211, elapsed.value);
   }
   else
   {
@@ -3299,7 +3348,8 @@ void Draw_Print_ProgressElapsed()
     {
       Clear_Print_Time();
     }
-    DWIN_Draw_String(false, false, font6x12, Color_White, Color_Bg_Black, 42, 212 + 3, F(">100H"));
+    if (Status_Changed(SF_ELAPSED_H, -1, 42, 212 + 3, 5 * 6, 12))
+      DWIN_Draw_String(false, false, font6x12, Color_White, Color_Bg_Black, 42, 212 + 3, F(">100H"));
   }
 #elif ENABLED(DWIN_CREALITY_320_LCD)
   if (elapsed.value < 360000)
@@ -3314,18 +3364,12 @@ void Draw_Print_ProgressElapsed()
     #if ENABLED(DWIN_RENDER_THUMBNAIL)
       if(hasThumbnail)
       {
-        DWIN_Draw_IntValue(true, true, 1, font8x16, Color_White, Color_Bg_Black, 2, 126, 123, elapsed.value / 3600);
-        DWIN_Draw_IntValue(true, true, 1, font8x16, Color_White, Color_Bg_Black, 2, 150, 123, (elapsed.value % 3600) / 60);
-        DWIN_Draw_String(false, false, font8x16, Color_White, Color_Bg_Black, 149, 121, F(":"));
+        Draw_Time_Value(SF_ELAPSED_H, 126, 123, 149, 121, elapsed.value);
       }else{
-        DWIN_Draw_IntValue(true, true, 1, font8x16, Color_White, Color_Bg_Black, 2, NUM_PRINT_TIME_X, NUM_PRINT_TIME_Y, elapsed.value / 3600);
-        DWIN_Draw_IntValue(true, true, 1, font8x16, Color_White, Color_Bg_Black, 2, NUM_PRINT_TIME_X + 24, NUM_PRINT_TIME_Y, (elapsed.value % 3600) / 60);
-        DWIN_Draw_String(false, false, font8x16, Color_White, Color_Bg_Black, NUM_PRINT_TIME_X + 22, NUM_PRINT_TIME_Y - 3, F(":"));
+        Draw_Time_Value(SF_ELAPSED_H, NUM_PRINT_TIME_X, NUM_PRINT_TIME_Y, NUM_PRINT_TIME_X + 22, NUM_PRINT_TIME_Y - 3, elapsed.value);
       }
     #else
-      DWIN_Draw_IntValue(true, true, 1, font8x16, Color_White, Color_Bg_Black, 2, NUM_PRINT_TIME_X, NUM_PRINT_TIME_Y, elapsed.value / 3600);
-      DWIN_Draw_IntValue(true, true, 1, font8x16, Color_White, Color_Bg_Black, 2, NUM_PRINT_TIME_X + 24, NUM_PRINT_TIME_Y, (elapsed.value % 3600) / 60);
-      DWIN_Draw_String(false, false, font8x16, Color_White, Color_Bg_Black, NUM_PRINT_TIME_X + 22, NUM_PRINT_TIME_Y - 3, F(":"));
+      Draw_Time_Value(SF_ELAPSED_H, NUM_PRINT_TIME_X, NUM_PRINT_TIME_Y, NUM_PRINT_TIME_X + 22, NUM_PRINT_TIME_Y - 3, elapsed.value);
     #endif  
   
   }
@@ -3339,12 +3383,15 @@ void Draw_Print_ProgressElapsed()
     #if ENABLED(DWIN_RENDER_THUMBNAIL)
       if(hasThumbnail)
       {
-        DWIN_Draw_String(false, false, font6x12, Color_White, Color_Bg_Black, 126, 123, F(">100H"));
+        if (Status_Changed(SF_ELAPSED_H, -1, 126, 123, 5 * 6, 12))
+          DWIN_Draw_String(false, false, font6x12, Color_White, Color_Bg_Black, 126, 123, F(">100H"));
       }else{
-        DWIN_Draw_String(false, false, font6x12, Color_White, Color_Bg_Black, NUM_PRINT_TIME_X, NUM_PRINT_TIME_Y, F(">100H"));
+        if (Status_Changed(SF_ELAPSED_H, -1, NUM_PRINT_TIME_X, NUM_PRINT_TIME_Y, 5 * 6, 12))
+          DWIN_Draw_String(false, false, font6x12, Color_White, Color_Bg_Black, NUM_PRINT_TIME_X, NUM_PRINT_TIME_Y, F(">100H"));
       }
     #else
-      DWIN_Draw_String(false, false, font6x12, Color_White, Color_Bg_Black, NUM_PRINT_TIME_X, NUM_PRINT_TIME_Y, F(">100H"));
+      if (Status_Changed(SF_ELAPSED_H, -1, NUM_PRINT_TIME_X, NUM_PRINT_TIME_Y, 5 * 6, 12))
+        DWIN_Draw_String(false, false, font6x12, Color_White, Color_Bg_Black, NUM_PRINT_TIME_X, NUM_PRINT_TIME_Y, F(">100H"));
     #endif
   }
 #endif
@@ -3417,18 +3464,12 @@ void Draw_Print_ProgressRemain()
     #if ENABLED(DWIN_RENDER_THUMBNAIL)
       if(hasThumbnail)
       {
-        DWIN_Draw_IntValue(true, true, 1, font8x16, Color_White, Color_Bg_Black, 2, 126, 144, ui.get_remaining_time() / 3600);
-        DWIN_Draw_IntValue(true, true, 1, font8x16, Color_White, Color_Bg_Black, 2, 150, 144, (ui.get_remaining_time() % 3600) / 60);
-        DWIN_Draw_String(false, false, font8x16, Color_White, Color_Bg_Black, 149, 143, F(":"));
+        Draw_Time_Value(SF_REMAIN_H, 126, 144, 149, 143, ui.get_remaining_time());
       }else{
-        DWIN_Draw_IntValue(true, true, 1, font8x16, Color_White, Color_Bg_Black, 2, NUM_RAMAIN_TIME_X, NUM_RAMAIN_TIME_Y, ui.get_remaining_time() / 3600);
-        DWIN_Draw_IntValue(true, true, 1, font8x16, Color_White, Color_Bg_Black, 2, NUM_RAMAIN_TIME_X + 24, NUM_RAMAIN_TIME_Y, (ui.get_remaining_time() % 3600) / 60);
-        DWIN_Draw_String(false, false, font8x16, Color_White, Color_Bg_Black, NUM_RAMAIN_TIME_X + 22, NUM_RAMAIN_TIME_Y - 3, F(":"));
+        Draw_Time_Value(SF_REMAIN_H, NUM_RAMAIN_TIME_X, NUM_RAMAIN_TIME_Y, NUM_RAMAIN_TIME_X + 22, NUM_RAMAIN_TIME_Y - 3, ui.get_remaining_time());
       }
     #else
-      DWIN_Draw_IntValue(true, true, 1, font8x16, Color_White, Color_Bg_Black, 2, NUM_RAMAIN_TIME_X, NUM_RAMAIN_TIME_Y, ui.get_remaining_time() / 3600);
-      DWIN_Draw_IntValue(true, true, 1, font8x16, Color_White, Color_Bg_Black, 2, NUM_RAMAIN_TIME_X + 24, NUM_RAMAIN_TIME_Y, (ui.get_remaining_time() % 3600) / 60);
-      DWIN_Draw_String(false, false, font8x16, Color_White, Color_Bg_Black, NUM_RAMAIN_TIME_X + 22, NUM_RAMAIN_TIME_Y - 3, F(":"));
+      Draw_Time_Value(SF_REMAIN_H, NUM_RAMAIN_TIME_X, NUM_RAMAIN_TIME_Y, NUM_RAMAIN_TIME_X + 22, NUM_RAMAIN_TIME_Y - 3, ui.get_remaining_time());
     #endif  
   }
   else
@@ -3837,7 +3878,7 @@ void HMI_Move_E()
     LIMIT(HMI_ValueStruct.Move_E_scaled, last_E_scaled - (EXTRUDE_MAXLENGTH_e)*MINUNITMULT, last_E_scaled + (EXTRUDE_MAXLENGTH_e)*MINUNITMULT);
     current_position.e = HMI_ValueStruct.Move_E_scaled / MINUNITMULT;
     DWIN_Draw_Signed_Float(font8x16, Select_Color, 3, UNITFDIGITS, VALUERANGE_X, MBASE(4), HMI_ValueStruct.Move_E_scaled);
-    delay(10); // Solve the problem that rapid rotation will select two values ​​​​together.
+    DWIN_Delay(10); // Solve the problem that rapid rotation will select two values ​​​​together.
     // DWIN_UpdateLCD();
     HMI_Plan_Move(MMM_TO_MMS(FEEDRATE_E));
   }
@@ -5034,9 +5075,10 @@ void update_middle_variable()
     _fanspeed = thermalManager.fan_speed[0];
 #endif
 
-  if (!ht)
+  // Put the still icons back once the heating animations stop
+  if (Status_Changed(SF_HOTEND_ICON, !ht, ICON_NOZZ_X, ICON_NOZZ_Y, 1, 1) && !ht)
     DWIN_ICON_Show(ICON, ICON_HotendTemp, ICON_NOZZ_X, ICON_NOZZ_Y);
-  if (!bt)
+  if (Status_Changed(SF_BED_ICON, !bt, ICON_BED_X, ICON_BED_Y, 1, 1) && !bt)
     DWIN_ICON_Show(ICON, ICON_BedTemp, ICON_BED_X, ICON_BED_Y);
 #if ENABLED(DWIN_CREALITY_480_LCD)
 
@@ -5073,50 +5115,47 @@ void update_middle_variable()
 #endif
   }
 
-  // Bottom temperature update
+  // Bottom temperature update. dwin_shadow skips the fields that haven't changed.
 
 #if HAS_HOTEND
-  DWIN_Draw_Signed_Float_Temp(DWIN_FONT_STAT, Color_Bg_Black, 3, 0, 25, NUM_NOZZ_Y - 2, _hotendtemp);
-  if (_new_hotend_target)
+  if (Status_Changed(SF_HOTEND_TEMP, _hotendtemp, 25, NUM_NOZZ_Y - 2, 4 * STAT_CHR_W, 22))
+    DWIN_Draw_Signed_Float_Temp(DWIN_FONT_STAT, Color_Bg_Black, 3, 0, 25, NUM_NOZZ_Y - 2, _hotendtemp);
+  if (Status_Changed(SF_HOTEND_TARGET, _hotendtarget, 18 + 4 * STAT_CHR_W + 6, NUM_NOZZ_Y, 3 * STAT_CHR_W, 20))
   {
     DWIN_Draw_IntValue_N0SPACE(true, true, 0, DWIN_FONT_STAT, Color_White, Color_Bg_Black, 3, 18 + 4 * STAT_CHR_W + 6, NUM_NOZZ_Y, _hotendtarget);
   }
-  static int16_t _flow = planner.flow_percentage[0];
-  if (_flow != planner.flow_percentage[0])
+  const int16_t _flow = planner.flow_percentage[0];
+  if (Status_Changed(SF_FLOW, _flow, 99 + 2 * STAT_CHR_W + 2, NUM_STEP_E_Y, 3 * STAT_CHR_W, 20))
   {
-    _flow = planner.flow_percentage[0];
     DWIN_Draw_IntValue_N0SPACE(true, true, 0, DWIN_FONT_STAT, Color_White, Color_Bg_Black, 3, 99 + 2 * STAT_CHR_W + 2, NUM_STEP_E_Y, _flow);
   }
 #endif
 
 #if HAS_HEATED_BED
-  DWIN_Draw_Signed_Float_Temp(DWIN_FONT_STAT, Color_Bg_Black, 3, 0, 25, NUM_BED_Y - 2, _bedtemp);
-  if (_new_bed_target)
+  if (Status_Changed(SF_BED_TEMP, _bedtemp, 25, NUM_BED_Y - 2, 4 * STAT_CHR_W, 22))
+    DWIN_Draw_Signed_Float_Temp(DWIN_FONT_STAT, Color_Bg_Black, 3, 0, 25, NUM_BED_Y - 2, _bedtemp);
+  if (Status_Changed(SF_BED_TARGET, _bedtarget, 18 + 4 * STAT_CHR_W + 6, NUM_BED_Y, 3 * STAT_CHR_W, 20))
   {
     DWIN_Draw_IntValue_N0SPACE(true, true, 0, DWIN_FONT_STAT, Color_White, Color_Bg_Black, 3, 18 + 4 * STAT_CHR_W + 6, NUM_BED_Y, _bedtarget);
   }
 #endif
 
-  static int16_t _feedrate = 100;
-  if (_feedrate != feedrate_percentage)
+  if (Status_Changed(SF_FEEDRATE, feedrate_percentage, 99 + 2 * STAT_CHR_W + 2, NUM_SPEED_Y, 3 * STAT_CHR_W, 20))
   {
-    _feedrate = feedrate_percentage;
-    DWIN_Draw_IntValue_N0SPACE(true, true, 0, DWIN_FONT_STAT, Color_White, Color_Bg_Black, 3, 99 + 2 * STAT_CHR_W + 2, NUM_SPEED_Y, _feedrate);
+    DWIN_Draw_IntValue_N0SPACE(true, true, 0, DWIN_FONT_STAT, Color_White, Color_Bg_Black, 3, 99 + 2 * STAT_CHR_W + 2, NUM_SPEED_Y, feedrate_percentage);
   }
 
 #if HAS_FAN
-  if (_new_fanspeed)
+  if (Status_Changed(SF_FAN, _fanspeed, 175 + 2 * STAT_CHR_W, NUM_FAN_Y, 3 * STAT_CHR_W, 20))
   {
-    _fanspeed = thermalManager.fan_speed[0];
     DWIN_Draw_IntValue_N0SPACE(true, true, 0, DWIN_FONT_STAT, Color_White, Color_Bg_Black, 3, 175 + 2 * STAT_CHR_W, NUM_FAN_Y, _fanspeed);
   }
 #endif
 
-  static float _offset = 0;
-  if (BABY_Z_VAR != _offset)
+  const float _offset = BABY_Z_VAR;
+  if (Status_Changed(SF_ZOFFSET, int32_t(_offset * 1000), 191, NUM_ZOFFSET_Y - 1, DWIN_WIDTH - 191, 21))
   {
-    _offset = BABY_Z_VAR;
-    if (BABY_Z_VAR < 0)
+    if (_offset < 0)
     {
       DWIN_Draw_FloatValue(true, true, 0, DWIN_FONT_STAT, Color_White, Color_Bg_Black, 2, 2, 191, NUM_ZOFFSET_Y, -_offset * 100);
       DWIN_Draw_String(false, true, font8x16, Color_White, Color_Bg_Black, 191, NUM_ZOFFSET_Y - 1, F("-"));
@@ -5361,6 +5400,8 @@ void HMI_SDCardUpdate()
     }
     else
     {
+      TERN_(DWIN_RENDER_THUMBNAIL, thumb.abort());
+      TERN_(DWIN_RENDER_THUMBNAIL, thumb_index.clear());
       // clean file icon
       if (checkkey == SelectFile)
       {
@@ -5502,12 +5543,13 @@ void Draw_Status_Area(bool with_update)
     // update_variable(); //The bottom parameter is refreshed only when the flag bit is 0
     update_middle_variable();
     DWIN_UpdateLCD();
-    delay(5);
+    DWIN_Delay(5);
   }
 }
 // Update all parameters in the middle
 void Draw_Mid_Status_Area(bool with_update)
 {
+  dwin_shadow.invalidate(); // Everything is drawn again from here
   DWIN_Draw_Rectangle(1, Color_Bg_Black, 0, STATUS_Y, DWIN_WIDTH, DWIN_HEIGHT - 1);
   HMI_flag.Refresh_bottom_flag = false; // Flag refresh bottom parameter
 #if ENABLED(DWIN_CREALITY_480_LCD)
@@ -5572,7 +5614,7 @@ void Draw_Mid_Status_Area(bool with_update)
   {
     update_middle_variable(); //
     DWIN_UpdateLCD();
-    delay(5);
+    DWIN_Delay(5);
   }
 }
 void HMI_StartFrame(const bool with_update)
@@ -6091,6 +6133,7 @@ static void Image_Preview_Information_Show(uint8_t ret)
 // Image preview interface
 #if ENABLED(DWIN_RENDER_THUMBNAIL)
   void Goto_ThumbPreview(){
+    thumb.clicked(millis());
 
     // SERIAL_ECHOLNPGM("Image Preview Info");
     // SERIAL_ECHOLNPGM("File Name: ", my_short_fn);
@@ -6113,30 +6156,35 @@ static void Image_Preview_Information_Show(uint8_t ret)
     #endif
 
     Draw_Show_G_Select_Highlight(true);
-    
-    char *const name = card.longest_filename();
-    char str[strlen(name) + 1];
-    // Cancel the suffix. For example: filename.gcode and remove .gocde.
-    make_name_without_ext(str, name);
-    
+
     // Show gcode file information
     uint8_t ret = METADATA_PARSE_ERROR;
     ret = read_gcode_model_information(my_short_fn);
     Image_Preview_Information_Show(ret);    
 
-    // search and render thumbnail  
-    DWIN_Draw_String(false, false, DWIN_FONT_HEAD, Color_Red, Color_Bg_Blue, 10, 4, F("Rendering Thumbnail... Wait"));
-    hasThumbnail = DWIN_RenderThumb(my_short_fn);
+    // search and render thumbnail from idle(), see DWIN_ThumbDone
+    DWIN_Draw_String(false, false, DWIN_FONT_HEAD, Color_Red, Color_Bg_Blue, 10, 4, F("Rendering Thumbnail..."));
+    hasThumbnail = false;
+    thumb.start(my_short_fn);
+  }
+
+  // Preview finished rendering (or there was none)
+  void DWIN_ThumbDone(const bool drawn) {
+    hasThumbnail = drawn;
+    if (checkkey != Show_gcode_pic) return;
 
-    if (!hasThumbnail) {
+    if (!drawn) {
       // SERIAL_ECHOLNPGM("No thumbnail found, displaying default image.");
       DC_Show_defaut_image(); // Show default image if no thumbnail is found
-    } else {
-      // SERIAL_ECHOLNPGM("Thumbnail displayed successfully.");
     }
+
+    char *const name = card.longest_filename();
+    char str[strlen(name) + 1];
+    // Cancel the suffix. For example: filename.gcode and remove .gocde.
+    make_name_without_ext(str, name);
     Clear_Title_Bar();
     Draw_Title(str);
-       
+    DWIN_UpdateLCD();
   }
 #endif  
 
@@ -6568,7 +6616,7 @@ void HMI_PauseOrStop()
         Clear_Main_Window();
         DWIN_ICON_Not_Filter_Show(Background_ICON, Background_reset, 0, 25);
         settings.save();
-        delay(100);
+        DWIN_Delay(100);
         HMI_ResetLanguage();
         HMI_ValueStruct.Auto_PID_Value[1] = 100; // Pid number reset
         HMI_ValueStruct.Auto_PID_Value[2] = 260; // Pid number reset
@@ -6593,7 +6641,7 @@ void HMI_Filament()
   if (READ(CHECKFILAMENT_PIN) && HMI_flag.cloud_printing_flag)
   {
     // Prevent shaking rock_20210910
-    delay(200);
+    DWIN_Delay(200);
     if (READ(CHECKFILAMENT_PIN))
     {
       SERIAL_ECHOLN(STR_BUSY_PAUSED_FOR_USER);
@@ -6602,7 +6650,7 @@ void HMI_Filament()
   else if (!READ(CHECKFILAMENT_PIN) && (!HMI_flag.filament_recover_flag))
   {
     // Prevent shaking rock_20210910
-    delay(200);
+    DWIN_Delay(200);
     if (!READ(CHECKFILAMENT_PIN))
     {
       HMI_flag.filament_recover_flag = true;
@@ -6613,7 +6661,7 @@ void HMI_Filament()
   else if (READ(CHECKFILAMENT_PIN) && (HMI_flag.filament_recover_flag))
   {
     // Prevent shaking rock_20210910
-    delay(200);
+    DWIN_Delay(200);
     if (READ(CHECKFILAMENT_PIN))
     {
       HMI_flag.filament_recover_flag = false;
@@ -6671,7 +6719,7 @@ void HMI_Filament()
       if (READ(CHECKFILAMENT_PIN) == 0)
       {
         // Prevent shaking rock_20210910
-        delay(200);
+        DWIN_Delay(200);
         // If(read(checkfilament pin))
         if (READ(CHECKFILAMENT_PIN) == 0)
         {
@@ -7701,7 +7749,7 @@ void HMI_Prepare()
       // checkkey = Last_Prepare;
       Popup_Window_Home();
       gcode.process_subcommands_now(PSTR("G28")); // home
-      delay(200);
+      DWIN_Delay(200);
       gcode.process_subcommands_now(PSTR("G1 X-15 Z40 F3500")); // raise Z
       checkkey = CExtrude_Menu;
       select_cextr.reset();
@@ -8165,7 +8213,7 @@ void HMI_Leveling()
       // LevelingBilinear bd;
       bedlevel.refresh_bed_level();
       settings.save(); // Save the edited leveling data to eeprom
-      delay(100);
+      DWIN_Delay(100);
       HMI_flag.G29_finish_flag = false; // Even after exiting the editing page and entering the leveling page, turning the knob is not allowed.
       if (HMI_flag.Edit_Only_flag)
       {
@@ -11029,7 +11077,7 @@ void HMI_Init()
   {
 
     DWIN_ICON_Not_Filter_Show(Background_ICON, Background_min + t, CREALITY_LOGO_X, CREALITY_LOGO_Y);
-    delay(30);
+    DWIN_Delay(30);
   }
   Read_Boot_Step_Value(); // Read the value of the boot step
   Read_Auto_PID_Value();
@@ -11067,6 +11115,9 @@ void DWIN_Update()
   EachMomentUpdate(); // Status update
 
   DWIN_HandleScreen(); // Rotary encoder update
+
+  TERN_(DWIN_RENDER_THUMBNAIL, thumb.task()); // Draw the next slice of the preview
+  dwin_tx.pump();                             // Keep queued frames moving to the panel
 }
 
 void Check_Filament_Update(void)
@@ -11159,6 +11210,17 @@ void Remove_card_window_check(void)
   }
 }
 
+// Check the print time once a second. Fields painted over by then are drawn again.
+static void Update_Print_ProgressElapsed(const millis_t ms)
+{
+  static millis_t next_elapsed_update_ms = 0;
+  if (ELAPSED(ms, next_elapsed_update_ms))
+  {
+    next_elapsed_update_ms = ms + DWIN_VAR_UPDATE_INTERVAL;
+    Draw_Print_ProgressElapsed();
+  }
+}
+
 void EachMomentUpdate()
 {
   static float card_Index = 0;
@@ -11173,6 +11235,13 @@ void EachMomentUpdate()
   {
     next_var_update_ms = ms + DWIN_VAR_UPDATE_INTERVAL;
 
+    static millis_t next_shadow_keyframe_ms = 0;
+    if (ELAPSED(ms, next_shadow_keyframe_ms))
+    {
+      next_shadow_keyframe_ms = ms + DWIN_SHADOW_KEYFRAME_INTERVAL;
+      dwin_shadow.invalidate();
+    }
+
     if (!HMI_flag.Refresh_bottom_flag)
     {
       update_middle_variable();
@@ -11337,6 +11406,13 @@ void EachMomentUpdate()
         DWIN_ICON_Not_Filter_Show(HMI_flag.language, LANGUAGE_Confirm, OK_BUTTON_X, OK_BUTTON_Y);
       }
 #endif
+
+      #if ENABLED(PLANNER_STARVATION_PROFILE)
+        // How often the motion system starved during this print
+        char str[40];
+        starvation_profile.summary(str);
+        DWIN_Draw_String(false, false, font6x12, Color_Yellow, Color_Bg_Black, STARVE_SUMMARY_X, STARVE_SUMMARY_Y, str);
+      #endif
     }
     else if (HMI_flag.pause_flag != printingIsPaused())
     {
@@ -11438,11 +11514,8 @@ void EachMomentUpdate()
     if (HMI_flag.cloud_printing_flag && (checkkey == PrintProcess) && !HMI_flag.filement_resume_flag)
   #endif  
   {
-    static uint16_t last_Printtime = 0;
     static uint16_t last_card_percent = 0;
     static bool flag = 0;
-    duration_t elapsed = print_job_timer.duration(); // print timer
-    const uint16_t min = (elapsed.value % 3600) / 60;
     // Update progress bar
     ui.set_progress(Cloud_Progress_Bar * PROGRESS_SCALE);
 
@@ -11456,13 +11529,8 @@ void EachMomentUpdate()
         Draw_Layer_Number();
       #endif
     }
-    // Update printing time
-    if (last_Printtime != min)
-    { // 1 minute update
-      // SERIAL_ECHOLNPGM(" elapsed.value=: ", elapsed.value);
-      last_Printtime = min;
-      Draw_Print_ProgressElapsed();
-    }
+    // Update printing time. Only the digits that changed are sent.
+    Update_Print_ProgressElapsed(ms);
     if (progress <= 1 && !flag)
     {
       flag = true;
@@ -11494,16 +11562,8 @@ void EachMomentUpdate()
       }
     }
 
-    duration_t elapsed = print_job_timer.duration(); // print timer
-
-    // Print time so far
-    static uint16_t last_Printtime = 0;
-    const uint16_t min = (elapsed.value % 3600) / 60;
-    if (last_Printtime != min)
-    { // 1 minute update
-      last_Printtime = min;
-      Draw_Print_ProgressElapsed();
-    }
+    // Print time so far. Only the digits that changed are sent.
+    Update_Print_ProgressElapsed(ms);
 
     // Estimate remaining time every 20 seconds
     static millis_t next_remain_time_update = 0;
@@ -11657,6 +11717,14 @@ void Show_G_Pic(void)
   }
   else if (encoder_diffState == ENCODER_DIFF_ENTER)
   {
+    #if ENABLED(DWIN_RENDER_THUMBNAIL)
+      // Release the file before printing or leaving. Keep the layout of a partly drawn preview.
+      if (thumb.busy())
+      {
+        thumb.abort();
+        hasThumbnail = thumb.rows > 0;
+      }
+    #endif
     // Get long file name
     const bool is_subdir = !card.flag.workDirIsRoot;
     const uint16_t filenum = select_file.now - 1 - is_subdir;
@@ -11790,7 +11858,7 @@ void Draw_Poweron_Select_language()
     // Draw_Language_Icon_AND_Word(i, FIRST_Y + i *WORD_INTERVAL);
     // DWIN_ICON_Show(ICON, ICON_Word_CN+i, FIRST_X, FIRST_Y+i*WORD_INTERVAL);
     DWIN_Draw_Line(Line_Color, LINE_START_X, LINE_START_Y + i * LINE_INTERVAL, LINE_END_X, LINE_END_Y + i * LINE_INTERVAL);
-    delay(2);
+    DWIN_Delay(2);
 #endif
   }
 }
@@ -38,6 +38,10 @@
 #include "../../marlinui.h"
 
 #include "dwin_lcd.h"
+#include "dwin_thumb.h"
+#if ENABLED(DWIN_THUMB_HEATSHRINK)
+  #include "../../../libs/heatshrink/heatshrink_decoder.h"
+#endif
 #include <string.h> // for memset
 
 //#define DEBUG_OUT 1
@@ -83,11 +87,21 @@ inline void DWIN_String(size_t &i, const __FlashStringHelper * string) {
   i += len;
 }
 
-// Send the data in the buffer and the packet end
+DWINTxQueue<decltype(LCD_SERIAL), DWIN_TX_QUEUE_SIZE> dwin_tx(LCD_SERIAL);
+DWINShadow dwin_shadow(DWIN_LCD_BYTES_PER_SEC);
+
+// Queue the data in the buffer and the packet end
 inline void DWIN_Send(size_t &i) {
   ++i;
-  LOOP_L_N(n, i) { LCD_SERIAL.write(DWIN_SendBuf[n]); delayMicroseconds(1); }
-  LOOP_L_N(n, 4) { LCD_SERIAL.write(DWIN_BufTail[n]); delayMicroseconds(1); }
+  dwin_tx.write(DWIN_SendBuf, i);
+  dwin_tx.write(DWIN_BufTail, 4);
+  dwin_tx.pump();
+}
+
+// Wait, sending queued frames meanwhile, so paced drawing code reaches the panel in step
+void DWIN_Delay(const millis_t ms) {
+  const millis_t end = millis() + ms;
+  do dwin_tx.pump(); while (PENDING(millis(), end));
 }
 
 /*--------------------------------------System variable function --------------------------------------*/
@@ -105,6 +119,7 @@ bool DWIN_Handshake(void)
   size_t i = 0;
   DWIN_Byte(i, 0x00);
   DWIN_Send(i);
+  dwin_tx.flush();
 
   while (LCD_SERIAL.available() > 0 && recnum < (signed)sizeof(databuf))
   {
@@ -172,6 +187,7 @@ void DWIN_Frame_Clear(const uint16_t color) {
   DWIN_Byte(i, 0x01);
   DWIN_Word(i, color);
   DWIN_Send(i);
+  dwin_shadow.invalidate();
 }
 
 // Draw a point
@@ -223,6 +239,7 @@ void DWIN_Draw_Line(uint16_t color, uint16_t xStart, uint16_t yStart, uint16_t x
   DWIN_Word(i, xEnd);
   DWIN_Word(i, yEnd);
   DWIN_Send(i);
+  dwin_shadow.cover(xStart, yStart, xEnd, yEnd);
 }
 
 // Draw a rectangle
@@ -262,6 +279,7 @@ void DWIN_Draw_Rectangle(uint8_t mode, uint16_t color,
   DWIN_Word(i, xEnd);
   DWIN_Word(i, yEnd);
   DWIN_Send(i);
+  if (mode) dwin_shadow.cover(xStart, yStart, xEnd, yEnd);
 }
 
 // Move a screen area
@@ -284,6 +302,7 @@ void DWIN_Frame_AreaMove(uint8_t mode, uint8_t dir, uint16_t dis,
   DWIN_Word(i, xEnd);
   DWIN_Word(i, yEnd);
   DWIN_Send(i);
+  dwin_shadow.cover(xStart, yStart, xEnd, yEnd);
 }
 
 // uint16_t color,uint8_t width,uint8_t x_step,uint16_t y_ratio channel fixed XsYs XeYe color thickness X step Y=0 position Y data ratio
@@ -373,6 +392,7 @@ void DWIN_SHOW_MAIN_PIC()
   DWIN_Byte(i, 0x70);
   DWIN_Word(i, 0);
   DWIN_Send(i);
+  dwin_shadow.invalidate();
 }
 // Draw a positive integer
 //  bShow: true=display background color; false=don't display background color
@@ -513,6 +533,7 @@ void DWIN_JPG_ShowAndCache(const uint8_t id)
   DWIN_Word(i, 0x2200);
   DWIN_Byte(i, id);
   DWIN_Send(i);     // AA 23 00 00 00 00 08 00 01 02 03 CC 33 C3 3C
+  dwin_shadow.invalidate();
 }
 
 // Draw an Icon
@@ -593,6 +614,7 @@ void DWIN_Frame_AreaCopy(uint8_t cacheID, uint16_t xStart, uint16_t yStart,
   DWIN_Word(i, x);
   DWIN_Word(i, y);
   DWIN_Send(i);
+  dwin_shadow.cover(x, y, x + (xEnd - xStart), y + (yEnd - yStart));
 }
 
 // Animate a series of icons
@@ -655,24 +677,11 @@ void DWIN_ICON_SHOW_SRAM(uint16_t x,uint16_t y,uint16_t addr)
 
 // Thumbnail read/write routines
 bool gcode_readline(char *buffer, const size_t bufsize) {
-  size_t i = 0;
-  while (!card.eof()) {
-    int16_t c = card.get();
-    if (c < 0) break;
-    if (c == '\n' || c == '\r') {
-      if (i == 0) continue;       // skip consecutive empty lines
-      break;
-    }
-    if (i + 1 < bufsize)         // leave space for '\0'
-      buffer[i++] = char(c);
-  }
-  buffer[i] = '\0';
-  return i > 0;
+  int16_t n;
+  while ((n = card.readLine(buffer, bufsize)) == 0) { /* skip empty lines */ }
+  return n > 0;
 }
 
-
-
-
 static uint16_t parse_hex4(const char *p) {
   uint16_t v = 0;
   for (uint8_t i = 0; i < 4; i++) {
@@ -688,7 +697,22 @@ static uint16_t parse_hex4(const char *p) {
 }
 
 
-bool find_thumb_raw16_header(uint16_t &w, uint16_t &h) {
+// Recognize a thumbnail start tag (after "; ") and its "96x96" size
+static ThumbFormat thumb_begin_tag(const char *p, uint16_t &w, uint16_t &h) {
+  ThumbFormat fmt;
+  if (strncmp(p, "E3V3SE_THUMB_RAW16_BEGIN", 24) == 0)    { fmt = THUMB_RAW16; p += 24; }
+  else if (strncmp(p, "E3V3SE_THUMB_BIN_BEGIN", 22) == 0) { fmt = THUMB_BIN;   p += 22; }
+  #if ENABLED(DWIN_THUMB_HEATSHRINK)
+    else if (strncmp(p, "E3V3SE_THUMB_HS_BEGIN", 21) == 0) { fmt = THUMB_HS;  p += 21; }
+  #endif
+  else return THUMB_NONE;
+
+  // Try to parse the "96x96" that comes right after
+  if (sscanf(p, "%hu%*c%hu", &w, &h) != 2) w = h = 96;
+  return fmt;
+}
+
+ThumbFormat find_thumb_header(uint16_t &w, uint16_t &h) {
   char line[96];
 
   // Always start from the beginning of the file
@@ -704,109 +728,306 @@ bool find_thumb_raw16_header(uint16_t &w, uint16_t &h) {
     char *p = line + 1;
     while (*p == ' ') p++;
 
-    // Buscamos: "; E3V3SE_THUMB_RAW16_BEGIN 96x96"
-    if (strncmp(p, "E3V3SE_THUMB_RAW16_BEGIN", 24) == 0) {
-      uint16_t tw = 0, th = 0;
-
-      // Try to parse the "96x96" that comes right after
-      if (sscanf(p + 24, "%hu%*c%hu", &tw, &th) == 2) {
-        w = tw;
-        h = th;
-      }
-      else {
-        w = 96;
-        h = 96;
-      }
-
-      SERIAL_ECHOPGM("RAW16 header found. w=96");
-      SERIAL_ECHOLNPGM(" h=96");
-      return true;
-    }
+    // Buscamos: "; E3V3SE_THUMB_<format>_BEGIN 96x96"
+    const ThumbFormat fmt = thumb_begin_tag(p, w, h);
+    if (fmt != THUMB_NONE) return fmt;
   }
 
-  // SERIAL_ECHOLNPGM("RAW16 header NOT found in first 50 lines.");
-  return false;
+  // SERIAL_ECHOLNPGM("Thumbnail header NOT found in first 50 lines.");
+  return THUMB_NONE;
 }
 
 
 static constexpr uint16_t THUMB_X_START = 12;
 static constexpr uint16_t THUMB_Y_START = 25;
 
- bool DWIN_RenderThumb(const char *filename) {
-  // SERIAL_ECHOLNPGM("DWIN_RenderThumb using: ", filename);
-  // SERIAL_ECHOLNPGM("Card current filename (before open): ", card.filename);
+// Flow control: queue a handshake behind the pending frames and wait for the
+// panel to answer it, so it never has more than one thumbnail row queued.
+//  Reply: AA 00 'O' 'K' CC 33 C3 3C
+static millis_t sync_deadline;
+static uint8_t sync_matched;
+static bool sync_ok;
 
-  card.openFileRead(filename);
-  if (!card.isFileOpen()) {
-    // SERIAL_ECHOLNPGM("No file open.");
-    return false;
+void DWIN_SyncStart(const uint32_t timeout_ms/*=DWIN_SYNC_TIMEOUT_MS*/) {
+  while (LCD_SERIAL.available() > 0) (void)LCD_SERIAL.read(); // Drop stale replies
+
+  size_t i = 0;
+  DWIN_Byte(i, 0x00);
+  DWIN_Send(i);
+
+  sync_matched = 0;
+  sync_ok = false;
+  sync_deadline = millis() + timeout_ms;
+}
+
+// Non-blocking: true once the panel has answered or the wait timed out
+bool DWIN_SyncPoll() {
+  static const uint8_t ok_reply[] = { FHONE, 0x00, 'O', 'K' };
+  if (sync_ok) return true;
+  dwin_tx.pump();
+  while (LCD_SERIAL.available() > 0) {
+    const uint8_t c = LCD_SERIAL.read();
+    sync_matched = (c == ok_reply[sync_matched]) ? sync_matched + 1 : (c == FHONE);
+    if (sync_matched == COUNT(ok_reply)) return (sync_ok = true);
   }
+  return ELAPSED(millis(), sync_deadline);
+}
+
+bool DWIN_WaitReady(const uint32_t timeout_ms/*=DWIN_SYNC_TIMEOUT_MS*/) {
+  DWIN_SyncStart(timeout_ms);
+  while (!DWIN_SyncPoll()) { /* nada */ }
+  return sync_ok;
+}
+
+#if ENABLED(DWIN_RENDER_THUMBNAIL)
+
+ThumbIndex thumb_index;
+
+thumb_index_t ThumbIndex::entry[DWIN_THUMB_INDEX_SIZE];
+uint8_t ThumbIndex::next;
+uint16_t ThumbIndex::hits, ThumbIndex::misses;
 
-  uint16_t w = 0, h = 0;
-  if (!find_thumb_raw16_header(w, h)) { // header not found, bail out
-    card.closefile();
-    return false;
+// Look up a file by its directory entry key, optionally claiming the oldest slot for it
+thumb_index_t* ThumbIndex::find(const uint32_t cluster, const uint32_t size, const uint32_t stamp, const bool add) {
+  if (!cluster) return nullptr;       // Empty files have no cluster to key on
+  for (uint8_t i = 0; i < DWIN_THUMB_INDEX_SIZE; i++) {
+    thumb_index_t &e = entry[i];
+    if (e.cluster == cluster && e.size == size && e.stamp == stamp) return &e;
   }
+  if (!add) return nullptr;
+  thumb_index_t &e = entry[next];
+  if (++next >= DWIN_THUMB_INDEX_SIZE) next = 0;
+  memset(&e, 0, sizeof(e));
+  e.cluster = cluster;
+  e.size = size;
+  e.stamp = stamp;
+  return &e;
+}
 
-  // header found, limit to max size
-  if (w > 96) w = 96;
-  if (h > 96) h = 96;
+void ThumbIndex::clear() {
+  memset(entry, 0, sizeof(entry));
+  next = 0;
+}
 
- 
-  char line[4 * 96 + 8]; // 384 hex + '; ' + '\0'
+// Index entry for the file that is open on the card
+static thumb_index_t* open_file_index(const bool add) {
+  dir_t d;
+  const uint32_t stamp = card.getFileDirEntry(&d) ? (uint32_t(d.lastWriteDate) << 16) | d.lastWriteTime : 0;
+  return thumb_index.find(card.getFileCluster(), card.getFileSize(), stamp, add);
+}
 
-  uint16_t y = 0;
-  while (y < h && gcode_readline(line, sizeof(line))) {
+ThumbRenderer thumb;
+
+ThumbRenderer::State ThumbRenderer::state; // = THUMB_IDLE
+char ThumbRenderer::fname[13];
+uint16_t ThumbRenderer::width, ThumbRenderer::height, ThumbRenderer::rows;
+ThumbFormat ThumbRenderer::format;
+bool ThumbRenderer::syncing;
+uint32_t ThumbRenderer::slice_max_us, ThumbRenderer::slices;
+uint32_t ThumbRenderer::click_ms, ThumbRenderer::preview_ms, ThumbRenderer::preview_max_ms;
+
+#if ENABLED(DWIN_THUMB_HEATSHRINK)
+  // Streaming state for E3V3SE_THUMB_HS: the decoder window, one line of
+  // compressed input and the row being filled
+  static heatshrink_decoder hsd;
+  static uint8_t hs_in[THUMB_HS_LINE_BYTES], hs_row[THUMB_MAX_W * 2];
+  static uint8_t hs_in_len, hs_in_pos;
+  static uint16_t hs_fill;
+#endif
+
+// Begin rendering the preview of a file. Progress is made in task().
+void ThumbRenderer::start(const char * const filename) {
+  abort();
+  strncpy(fname, filename, sizeof(fname) - 1);
+  fname[sizeof(fname) - 1] = '\0';
+  width = height = rows = 0;
+  syncing = false;
+  state = THUMB_OPEN;
+}
 
-    // Skip lines other than image data
-    if (line[0] != ';') continue;
+// Stop rendering and release the file. No completion callback is made.
+void ThumbRenderer::abort() {
+  if (state == THUMB_IDLE) return;
+  if (state != THUMB_OPEN && owns_file()) card.closefile();
+  state = THUMB_IDLE;
+}
 
-    const char *p = line + 1;
-    while (*p == ' ') p++;
+// The file is shared with the host and the print job, so make sure it's still ours
+bool ThumbRenderer::owns_file() {
+  return card.isFileOpen() && !card.isPrinting() && strcmp(card.filename, fname) == 0;
+}
 
-    // Have we reached the END?
-    if (strncmp(p, "E3V3SE_THUMB_RAW16_END", 23) == 0) {
-      // SERIAL_ECHOLNPGM("RAW16 end reached.");
-      break;
+void ThumbRenderer::finish() {
+  if (owns_file()) card.closefile();
+  state = THUMB_IDLE;
+  if (click_ms) {
+    preview_ms = millis() - click_ms;
+    NOLESS(preview_max_ms, preview_ms);
+    click_ms = 0;
+  }
+  // SERIAL_ECHOLNPGM("RAW16 drawn rows: ", rows);
+  DWIN_ThumbDone(rows > 0);
+}
+
+void ThumbRenderer::begin_rows() {
+  #if ENABLED(DWIN_THUMB_HEATSHRINK)
+    heatshrink_decoder_reset(&hsd);
+    hs_in_len = hs_in_pos = 0;
+    hs_fill = 0;
+  #endif
+  state = THUMB_ROWS;
+}
+
+/**
+ * Get the next row of pixels from the file.
+ * Returns 1 with a row, 0 if this step produced no row, -1 at the end of the image.
+ */
+int8_t ThumbRenderer::read_row(uint16_t * const row) {
+  #if ENABLED(DWIN_THUMB_HEATSHRINK)
+    if (format == THUMB_HS) {
+      for (;;) {
+        // Decode straight into the row buffer
+        size_t n;
+        heatshrink_decoder_poll(&hsd, hs_row + hs_fill, width * 2 - hs_fill, &n);
+        hs_fill += n;
+        if (hs_fill == width * 2) {
+          hs_fill = 0;
+          for (uint16_t x = 0; x < width; x++) row[x] = (uint16_t(hs_row[x * 2]) << 8) | hs_row[x * 2 + 1];
+          return 1;
+        }
+        // Hand the decoder more of the current line
+        if (hs_in_pos < hs_in_len) {
+          heatshrink_decoder_sink(&hsd, hs_in + hs_in_pos, hs_in_len - hs_in_pos, &n);
+          hs_in_pos += n;
+          continue;
+        }
+        break;  // Need another line
+      }
     }
+  #endif
+
+  char line[4 * THUMB_MAX_W + 8]; // 384 hex + '; ' + '\0'
+  if (!gcode_readline(line, sizeof(line))) return -1;
+
+  // Skip lines other than image data
+  if (line[0] != ';') return 0;
 
-    const size_t len = strlen(p);
-    if (len < w * 4) {
-      // SERIAL_ECHOLNPGM("Line too short for RAW16: len=", len);
+  const char *p = line + 1;
+  while (*p == ' ') p++;
+
+  // End of data
+  if (strncmp(p, "E3V3SE_THUMB_", 13) == 0) return -1;
+
+  switch (format) {
+    case THUMB_BIN:
+      // Leave a damaged row blank and carry on with the next
+      if (!thumb_bin_decode_row(p, row, width)) { rows++; return 0; }
+      return 1;
+
+    #if ENABLED(DWIN_THUMB_HEATSHRINK)
+      case THUMB_HS: {
+        const int16_t n = thumb_b64_decode(p, hs_in, sizeof(hs_in));
+        if (n < 0) return -1;
+        hs_in_len = n;
+        hs_in_pos = 0;
+        return 0;
+      }
+    #endif
+
+    default:
+      // A line too short for RAW16
+      if (strlen(p) < width * 4u) return -1;
+      for (uint16_t x = 0; x < width; x++) row[x] = parse_hex4(p + x * 4);
+      return 1;
+  }
+}
+
+// Advance by one step. Return false to yield the rest of the slice.
+bool ThumbRenderer::step() {
+  switch (state) {
+    case THUMB_OPEN:
+      // Normally still open from read_gcode_model_information()
+      if (!owns_file()) card.openFileRead(fname);
+      if (!card.isFileOpen()) { finish(); return false; }
+      state = THUMB_HEADER;
       break;
-    }
 
-    // Quick debug of the first row
-    // if (y == 35) {
-    //   SERIAL_ECHOLNPGM("RAW16 data row: ");
-    //   SERIAL_ECHO(p);
-    //   SERIAL_ECHOLNPGM("");
-    // }
+    case THUMB_HEADER: {
+      if (!owns_file()) { finish(); return false; }
+
+      // Seen this file before? Go straight to the pixels.
+      thumb_index_t * const ix = open_file_index(true);
+      if (ix && (ix->flags & ThumbIndex::NO_THUMB)) { finish(); return false; }
+      if (ix && (ix->flags & ThumbIndex::HAS_THUMB)) {
+        width = ix->thumb_w;
+        height = ix->thumb_h;
+        format = ThumbFormat(ix->thumb_fmt);
+        card.setIndex(ix->thumb_pos);
+        begin_rows();
+        break;
+      }
+
+      format = find_thumb_header(width, height);
+      if (format == THUMB_NONE) {
+        if (ix) ix->flags |= ThumbIndex::NO_THUMB;
+        finish();
+        return false;
+      }
+      // header found, limit to max size
+      NOMORE(width, THUMB_MAX_W);
+      NOMORE(height, THUMB_MAX_H);
+      if (ix) {
+        ix->thumb_pos = card.getIndex();  // Just past the header line
+        ix->thumb_w = width;
+        ix->thumb_h = height;
+        ix->thumb_fmt = format;
+        ix->flags |= ThumbIndex::HAS_THUMB;
+      }
+      begin_rows();
+    } break;
 
-    for (uint16_t x = 0; x < w; x++) {
-      const char *px = p + x * 4;
-      const uint16_t color = parse_hex4(px);
+    case THUMB_ROWS: {
+      // Wait for the panel to drain the previous row
+      if (syncing && !DWIN_SyncPoll()) return false;
+      syncing = false;
 
-      // Debug some points to see if they come out other than 0
-      // if ((y == 35 && (x == 0 || x == w/2 || x == w-1))) {
-      //   SERIAL_ECHOPGM("px(", x);
-      //   SERIAL_ECHOPGM(",", y);
-      //   SERIAL_ECHOLNPGM(") color=", color);
-      // }
+      if (rows >= height || !owns_file()) { state = THUMB_CLOSE; break; }
 
-      DWIN_Draw_Rectangle(1, color,THUMB_X_START + x, THUMB_Y_START + y, THUMB_X_START + x, THUMB_Y_START + y);
-      delay(4); // give some time to DWIN to process the data
+      uint16_t row[THUMB_MAX_W];
+      const int8_t got = read_row(row);
+      if (got < 0) { state = THUMB_CLOSE; break; }
+      if (got == 0) break;
 
-    }
+      // Push the whole row as color runs, then let the panel drain it
+      DWINThumbBlit<decltype(dwin_tx)>::row(dwin_tx, THUMB_X_START, THUMB_Y_START + rows, row, width);
+      dwin_tx.pump();
+      DWIN_SyncStart();
+      syncing = true;
+      rows++;
+    } break;
+
+    case THUMB_CLOSE: finish(); return false;
 
-    y++;
+    default: return false;
   }
+  return true;
+}
+
+// Called from idle(). Spend at most DWIN_THUMB_SLICE_MS on rendering.
+void ThumbRenderer::task() {
+  if (state == THUMB_IDLE) return;
+
+  const uint32_t start_us = micros();
+  const millis_t end_ms = millis() + (DWIN_THUMB_SLICE_MS);
+  while (step() && state != THUMB_IDLE && PENDING(millis(), end_ms)) { /* nada */ }
 
-  card.closefile();
-  // SERIAL_ECHOLNPGM("RAW16 drawn rows: ", y);
-  return y > 0;
+  const uint32_t us = micros() - start_us;
+  NOLESS(slice_max_us, us);
+  slices++;
 }
 
+#endif // DWIN_RENDER_THUMBNAIL
+
 // ----
 #define ORCA_FOOTER_WINDOW    32768UL     //Bytes from the end that we are going to scan
 
@@ -856,60 +1077,49 @@ model_information_t model_information;
 //   "Layer height"
 // };
 
-uint8_t read_gcode_model_information(const char* fileName) {
+// Where the thumbnail pixel rows start, if the header has them
+typedef struct { uint32_t pos; uint16_t w, h; ThumbFormat fmt; } thumb_locator_t;
+
+/**
+ * Single-pass extractor for the open file. Reads the header once, picking up
+ * Cura-style metadata and the thumbnail location, then (for Orca files) the
+ * footer once.
+ */
+static uint8_t parse_model_information(thumb_locator_t &thumb_loc) {
   char string_buf[_GCODE_METADATA_STRING_LENGTH_MAX + 1];
-  char byte;
   uint16_t line_idx = 0;
-  // SERIAL_ECHOLNPGM("read_gcode_model using: ", fileName);
-  // SERIAL_ECHOLNPGM("Card current filename: ", card.filename);
-
-  // SERIAL_ECHOLNPAIR("Reading model information from G-code file: ", fileName);
-  // SERIAL_ECHOLN("Resetting model information variables.");
-  ui.reset_remaining_time();
-  ui.total_time_reset();
-  
-  #if ENABLED(DWIN_RENDER_THUMBNAIL)
-    ui.set_total_layers(0);
-    ui.set_current_layer(0);
-  #endif
-  // memset(&model_information, 0, sizeof(model_information)); 
-  memset(model_information.filament, 0, sizeof(model_information.filament));
-  memset(model_information.height,   0, sizeof(model_information.height));
-  
-  // SERIAL_ECHOLNPAIR("Remaining time reset to: ", ui.get_remaining_time());
-  // SERIAL_ECHOLNPAIR("Total time reset to: ", ui.get_total_time());
-  // SERIAL_ECHOLNPAIR("Model filament info: ", model_information.filament);
-  // SERIAL_ECHOLNPAIR("Model height info: ", model_information.height);
-
-
-  card.openFileRead(fileName);
-  if (!card.isFileOpen())
-    return METADATA_PARSE_ERROR;
 
   bool is_orca            = false;
   bool have_cura_time     = false;
   bool have_cura_filament = false;
   bool have_cura_height   = false;
 
+  // Rows of the thumbnail block are skipped without using up the line budget,
+  // up to a bound in case the END tag is missing (HS needs ~330 lines at 96x96)
+  constexpr uint16_t thumb_lines_max = 512;
+  uint16_t thumb_lines = 0;
+  bool in_thumb = false;
+
+  thumb_loc.pos = thumb_loc.w = thumb_loc.h = 0;
+  thumb_loc.fmt = THUMB_NONE;
+
   // ---------------------------------------------------------------------------
   // PASS 1: first MAX_HEADER_LINES
   //   -Search for Cura-type header (TIME, Filament used, Layer height)
   //   -Detect if it is OrcaSlicer
+  //   -Locate the thumbnail. Cura's header may come before or after it.
   // ---------------------------------------------------------------------------
-  while (!card.eof() && line_idx++ < _GCODE_METADATA_STRING_LENGTH_MAX) {
-
-    // Read a full line
-    uint16_t i = 0;
-    while (!card.eof() && i < _GCODE_METADATA_STRING_LENGTH_MAX) {
-      int16_t c = card.get();
-      if (c < 0) break;
-      byte = (char)c;
-      if (byte == '\r' || byte == '\n') break;
-      string_buf[i++] = byte;
+  card.setIndex(0);
+  while (line_idx++ < _GCODE_METADATA_STRING_LENGTH_MAX && card.readLine(string_buf, sizeof(string_buf)) >= 0) {
+
+    if (in_thumb) {
+      line_idx--;
+      if (strstr(string_buf, "E3V3SE_THUMB_") && strstr(string_buf, "_END")) in_thumb = false;
+      else if (++thumb_lines >= thumb_lines_max) break;
+      continue;
     }
-    string_buf[i] = '\0';
 
-    if (i == 0)
+    if (!string_buf[0])
       continue;
 
     #if ENABLED(USER_LOGIC_DEUBG)
@@ -932,6 +1142,17 @@ uint8_t read_gcode_model_information(const char* fileName) {
     if (!*char_pos)
       continue;
 
+    // "; E3V3SE_THUMB_<format>_BEGIN 96x96"
+    if (thumb_loc.fmt == THUMB_NONE) {
+      thumb_loc.fmt = thumb_begin_tag(char_pos, thumb_loc.w, thumb_loc.h);
+      if (thumb_loc.fmt != THUMB_NONE) {
+        thumb_loc.pos = card.getIndex();
+        if (have_cura_time && have_cura_filament && have_cura_height) break;
+        in_thumb = true;
+        continue;
+      }
+    }
+
     // ---Curate style ---
     // ;TIMES:441
     if (!have_cura_time && strncmp(char_pos, "TIME", 4) == 0) {
@@ -971,23 +1192,19 @@ uint8_t read_gcode_model_information(const char* fileName) {
       have_cura_height = true;
     }
 
-    if (have_cura_time && have_cura_filament && have_cura_height) {
-      // Card.closefile();
-      ui.set_remaining_time(ui.get_total_time());
-      // SERIAL_ECHOLN("Cura-type header detected and parsed successfully.");
-      // SERIAL_ECHOLNPAIR("Total time: ", ui.get_total_time());
-      // SERIAL_ECHOLNPAIR("Remaining time: ", ui.get_remaining_time());
-      // SERIAL_ECHOLNPAIR("Filament used: ", model_information.filament);
-      // SERIAL_ECHOLNPAIR("Layer height: ", model_information.height);
-      return METADATA_PARSE_OK;
-    }
+    // Everything found, no need to read further
+    if (thumb_loc.fmt != THUMB_NONE && have_cura_time && have_cura_filament && have_cura_height)
+      break;
+  }
+
+  if (have_cura_time && have_cura_filament && have_cura_height) {
+    ui.set_remaining_time(ui.get_total_time());
+    return METADATA_PARSE_OK;
   }
 
   // If it is not Orca and we did not find a Cura-type header, exit
-  if (!is_orca) {
-    // Card.closefile();
+  if (!is_orca)
     return METADATA_PARSE_ERROR;
-  }
 
   // ---------------------------------------------------------------------------
   // PASS 2: Orca footer (from the end of the file)
@@ -1004,11 +1221,7 @@ uint8_t read_gcode_model_information(const char* fileName) {
   card.setIndex(filesize - window);
 
   // Consume first partial line (we are in the middle of a line)
-  while (!card.eof()) {
-    int16_t c = card.get();
-    if (c < 0) break;
-    if (c == '\n' || c == '\r') break;
-  }
+  if (window < filesize) card.readLine(string_buf, sizeof(string_buf));
 
   bool have_filament_mm   = false;
   bool have_layers        = false;
@@ -1020,19 +1233,7 @@ uint8_t read_gcode_model_information(const char* fileName) {
   uint32_t orca_time_sec        = 0;
   uint16_t orca_layers          = 0;
 
-  while (!card.eof()) {
-    uint16_t i = 0;
-    while (!card.eof() && i < _GCODE_METADATA_STRING_LENGTH_MAX) {
-      int16_t c = card.get();
-      if (c < 0) break;
-      byte = (char)c;
-      if (byte == '\r' || byte == '\n') break;
-      string_buf[i++] = byte;
-    }
-    string_buf[i] = '\0';
-
-    if (i == 0)
-      continue;
+  while (card.readLine(string_buf, sizeof(string_buf)) >= 0) {
 
     if (string_buf[0] != ';')
       continue;
@@ -1152,4 +1353,78 @@ uint8_t read_gcode_model_information(const char* fileName) {
 }
 
 
+uint8_t read_gcode_model_information(const char* fileName) {
+  // SERIAL_ECHOLNPGM("read_gcode_model using: ", fileName);
+  // SERIAL_ECHOLNPGM("Card current filename: ", card.filename);
+
+  // SERIAL_ECHOLNPAIR("Reading model information from G-code file: ", fileName);
+  // SERIAL_ECHOLN("Resetting model information variables.");
+  ui.reset_remaining_time();
+  ui.total_time_reset();
+  
+  #if ENABLED(DWIN_RENDER_THUMBNAIL)
+    ui.set_total_layers(0);
+    ui.set_current_layer(0);
+  #endif
+  // memset(&model_information, 0, sizeof(model_information)); 
+  memset(model_information.filament, 0, sizeof(model_information.filament));
+  memset(model_information.height,   0, sizeof(model_information.height));
+  
+  // SERIAL_ECHOLNPAIR("Remaining time reset to: ", ui.get_remaining_time());
+  // SERIAL_ECHOLNPAIR("Total time reset to: ", ui.get_total_time());
+  // SERIAL_ECHOLNPAIR("Model filament info: ", model_information.filament);
+  // SERIAL_ECHOLNPAIR("Model height info: ", model_information.height);
+
+
+  card.openFileRead(fileName);
+  if (!card.isFileOpen())
+    return METADATA_PARSE_ERROR;
+
+  #if ENABLED(DWIN_RENDER_THUMBNAIL)
+    // Seen this file before? Use what was parsed last time.
+    // Hits and misses are counted here, once per file shown, not in find().
+    thumb_index_t * const ix = open_file_index(true);
+    if (ix && (ix->flags & ThumbIndex::HAS_META)) {
+      thumb_index.hits++;
+      ui.set_total_time(ix->total_time);
+      ui.set_total_layers(ix->layers);
+      strcpy(model_information.filament, ix->filament);
+      strcpy(model_information.height, ix->height);
+      if (!(ix->flags & ThumbIndex::META_OK)) return METADATA_PARSE_ERROR;
+      ui.set_remaining_time(ui.get_total_time());
+      return METADATA_PARSE_OK;
+    }
+  #endif
+
+  TERN_(DWIN_RENDER_THUMBNAIL, thumb_index.misses++);
+
+  thumb_locator_t thumb_loc;
+  const uint8_t ret = parse_model_information(thumb_loc);
+
+  #if ENABLED(DWIN_RENDER_THUMBNAIL)
+    if (ix) {
+      ix->total_time = ui.get_total_time();
+      ix->layers = ui.get_total_layer_count();
+      strcpy(ix->filament, model_information.filament);
+      strcpy(ix->height, model_information.height);
+      ix->flags |= ThumbIndex::HAS_META | (ret == METADATA_PARSE_OK ? ThumbIndex::META_OK : 0);
+
+      // The header pass also found (or ruled out) the thumbnail
+      if (thumb_loc.pos) {
+        ix->thumb_pos = thumb_loc.pos;
+        ix->thumb_w = _MIN(thumb_loc.w, THUMB_MAX_W);
+        ix->thumb_h = _MIN(thumb_loc.h, THUMB_MAX_H);
+        ix->thumb_fmt = thumb_loc.fmt;
+        ix->flags |= ThumbIndex::HAS_THUMB;
+      }
+      else
+        ix->flags |= ThumbIndex::NO_THUMB;
+    }
+  #endif
+
+
+  return ret;
+}
+
+
 #endif // Dwin creality lcd
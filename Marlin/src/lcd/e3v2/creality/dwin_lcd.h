@@ -91,7 +91,6 @@ extern char my_short_fn[13];
 
 /*-------------------------------------- System variable function --------------------------------------*/
 extern uint8_t read_gcode_model_information(const char* fileName);
-extern bool DWIN_RenderThumb(const char *filename);
 
 
 void Draw_Curve_Set(uint8_t line_wide,uint8_t step_x,uint16_t step_y,uint32_t colour);
@@ -99,6 +98,29 @@ void Draw_Curve_Data(uint8_t index,int16_t* temp_data);
 // Handshake (1: Success, 0: Fail)
 bool DWIN_Handshake(void);
 
+// All frames go through this queue. DWIN_Update() and DWIN_Delay() keep it draining.
+#include "dwin_tx.h"
+#ifndef DWIN_TX_QUEUE_SIZE
+  #define DWIN_TX_QUEUE_SIZE 1024
+#endif
+extern DWINTxQueue<decltype(LCD_SERIAL), DWIN_TX_QUEUE_SIZE> dwin_tx;
+void DWIN_Delay(const millis_t ms);
+
+// Last drawn value of each status field. Fills and clears below forget the fields they cover.
+#include "dwin_shadow.h"
+#ifndef DWIN_LCD_BYTES_PER_SEC
+  #define DWIN_LCD_BYTES_PER_SEC 4000
+#endif
+extern DWINShadow dwin_shadow;
+
+// Wait for the panel to process all queued frames (1: Success, 0: Timeout)
+#ifndef DWIN_SYNC_TIMEOUT_MS
+  #define DWIN_SYNC_TIMEOUT_MS 20
+#endif
+bool DWIN_WaitReady(const uint32_t timeout_ms=DWIN_SYNC_TIMEOUT_MS);
+void DWIN_SyncStart(const uint32_t timeout_ms=DWIN_SYNC_TIMEOUT_MS);
+bool DWIN_SyncPoll();
+
 // Common DWIN startup
 void DWIN_Startup(void);
 
@@ -0,0 +1,110 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+/**
+ * DWIN status field shadow
+ *
+ * Remembers the value last drawn into each status field and where it sits,
+ * so the periodic refresh only sends frames for fields whose value changed.
+ * Zero-filled numbers are also compared digit by digit, letting the caller
+ * redraw just the trailing digits that differ.
+ *
+ * Drawing primitives that paint over an area call cover(), and screen
+ * changes call invalidate(), so a field that was painted over is drawn in
+ * full the next time. Changed fields share a per-second byte budget with all
+ * other LCD traffic; an update refused by the budget stays pending and the
+ * next refresh retries it. Fields that must be drawn in full ignore the budget.
+ *
+ * Header-only so the unit tests can drive it without a panel.
+ */
+
+#include <stdint.h>
+
+#define DWIN_SHADOW_FIELDS 32
+
+class DWINShadow {
+  struct field_t { int32_t value; uint16_t xs, ys, xe, ye; };
+
+  field_t field[DWIN_SHADOW_FIELDS];
+  uint32_t valid;                     // One bit per field that is on screen as recorded
+  uint32_t window_ms, window_bytes;   // Start of the budget second and the LCD byte count then
+
+public:
+  uint16_t budget;                    // LCD bytes per second before changed fields wait, 0 for no limit
+  uint32_t drawn,                     // Updates the caller was told to draw
+           skipped,                   // Updates dropped because nothing changed
+           deferred;                  // Updates held back by the budget
+
+  DWINShadow(const uint16_t bytes_per_sec=0) : valid(0), window_ms(0), window_bytes(0),
+    budget(bytes_per_sec), drawn(0), skipped(0), deferred(0) {}
+
+  bool is_valid(const uint8_t f) const { return valid & (1UL << f); }
+  int32_t value(const uint8_t f) const { return field[f].value; }
+
+  void invalidate() { valid = 0; }
+  void invalidate(const uint8_t f) { valid &= ~(1UL << f); }
+
+  // Forget every field overlapping a painted rectangle
+  void cover(const uint16_t xs, const uint16_t ys, const uint16_t xe, const uint16_t ye) {
+    for (uint8_t f = 0; f < DWIN_SHADOW_FIELDS; f++) {
+      if (!is_valid(f)) continue;
+      const field_t &d = field[f];
+      if (xs <= d.xe && xe >= d.xs && ys <= d.ye && ye >= d.ys) invalidate(f);
+    }
+  }
+
+  // Is there budget left this second? tx_bytes is the running count of LCD bytes queued.
+  bool allow(const uint32_t tx_bytes, const uint32_t ms) {
+    if (!budget) return true;
+    if (ms - window_ms >= 1000UL) { window_ms = ms; window_bytes = tx_bytes; }
+    return tx_bytes - window_bytes < budget;
+  }
+
+  /**
+   * Offer a new value for field f, which covers xs,ys to xe,ye.
+   * Returns true if the caller should draw it now. The field is then recorded as on screen.
+   */
+  bool update(const uint8_t f, const int32_t v, const uint16_t xs, const uint16_t ys, const uint16_t xe, const uint16_t ye,
+              const uint32_t tx_bytes, const uint32_t ms
+  ) {
+    if (is_valid(f)) {
+      if (field[f].value == v) { skipped++; return false; }
+      if (!allow(tx_bytes, ms)) { deferred++; return false; }
+    }
+    field_t &d = field[f];
+    d.value = v; d.xs = xs; d.ys = ys; d.xe = xe; d.ye = ye;
+    valid |= 1UL << f;
+    drawn++;
+    return true;
+  }
+
+  // Number of trailing digits that differ between two zero-filled values of the given width
+  static uint8_t changed_digits(uint32_t was, uint32_t now, const uint8_t digits) {
+    uint8_t run = 0;
+    for (uint8_t i = 1; i <= digits; i++, was /= 10, now /= 10)
+      if (was % 10 != now % 10) run = i;
+    return run;
+  }
+
+  void reset_stats() { drawn = skipped = deferred = 0; }
+};
@@ -0,0 +1,283 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+/**
+ * DWIN thumbnail row blitter
+ *
+ * The panel has no raw RGB565 bitmap command (the SRAM icon path only
+ * accepts JPEG data), so a row is pushed as runs of equal color: one
+ * "set color" frame plus one "fill rectangle" frame per run. Flat
+ * backgrounds collapse into a few frames per row instead of a frame pair
+ * per pixel, and the caller paces rows with a handshake instead of sleeps.
+ *
+ * Header-only and templated on the port so it can be driven by LCD_SERIAL
+ * on the printer and by a mock port in the unit tests.
+ */
+
+#include <stdint.h>
+
+#define THUMB_MAX_W 96
+#define THUMB_MAX_H 96
+
+// Bytes on the wire for the frames used by the blitter (0xAA head + payload + 4 byte tail)
+#define DWIN_FRAME_OVERHEAD   5
+#define DWIN_SET_COLOR_BYTES  (DWIN_FRAME_OVERHEAD + 5)
+#define DWIN_FILL_RECT_BYTES  (DWIN_FRAME_OVERHEAD + 9)
+
+template<typename PORT>
+class DWINThumbBlit {
+  static void word(PORT &port, const uint16_t w) { port.write(uint8_t(w >> 8)); port.write(uint8_t(w & 0xFF)); }
+
+  static void head(PORT &port, const uint8_t cmd) { port.write(0xAA); port.write(cmd); }
+
+  static void tail(PORT &port) { port.write(0xCC); port.write(0x33); port.write(0xC3); port.write(0x3C); }
+
+public:
+  // Set the foreground color used by the following fill
+  static void set_color(PORT &port, const uint16_t fc, const uint16_t bc=0xFFFF) {
+    head(port, 0x40); word(port, fc); word(port, bc); tail(port);
+  }
+
+  // Fill a rectangle with the current foreground color
+  static void fill_rect(PORT &port, const uint16_t xs, const uint16_t ys, const uint16_t xe, const uint16_t ye) {
+    head(port, 0x5B); word(port, xs); word(port, ys); word(port, xe); word(port, ye); tail(port);
+  }
+
+  /**
+   * Draw one row of RGB565 pixels at x,y as runs of equal color.
+   * Returns the number of bytes written to the port.
+   */
+  static uint16_t row(PORT &port, const uint16_t x, const uint16_t y, const uint16_t *px, const uint8_t w) {
+    uint16_t bytes = 0;
+    for (uint8_t s = 0; s < w;) {
+      const uint16_t color = px[s];
+      uint8_t e = s;
+      while (e + 1 < w && px[e + 1] == color) e++;
+      set_color(port, color);
+      fill_rect(port, x + s, y, x + e, y);
+      bytes += DWIN_SET_COLOR_BYTES + DWIN_FILL_RECT_BYTES;
+      s = e + 1;
+    }
+    return bytes;
+  }
+};
+
+/**
+ * E3V3SE_THUMB_BIN row decoder
+ *
+ * Written by SlicerScripts/orca_parser.py as an alternative to RAW16:
+ *
+ *   ; E3V3SE_THUMB_BIN_BEGIN 96x96
+ *   ; <base64 row>        (one line per row)
+ *   ; E3V3SE_THUMB_BIN_END
+ *
+ * A row decodes to PackBits-style packets of big-endian RGB565 colors
+ * followed by a big-endian CRC-16 (crc16(), init 0) of the packet bytes:
+ *
+ *   0x80 | (n - 1), color      n pixels of one color
+ *   0x00 | (n - 1), colors...  n literal colors
+ *
+ * Flat areas take 3 bytes per run and busy rows at most ~2 bytes per pixel,
+ * against 4 characters per pixel for RAW16.
+ */
+
+#include "../../../libs/crc16.h"
+
+// Packet bytes + CRC for the worst-case row
+#define THUMB_BIN_ROW_BYTES (3 * (THUMB_MAX_W) + 2)
+
+enum ThumbFormat : uint8_t { THUMB_NONE, THUMB_RAW16, THUMB_BIN, THUMB_HS };
+
+// Value of a base64 character, or -1
+inline int8_t thumb_b64_value(const char c) {
+  static const int8_t table[80] = {                                             // '+' ... 'z'
+    62, -1, -1, -1, 63, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1, -1,
+     0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
+    22, 23, 24, 25, -1, -1, -1, -1, -1, -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37,
+    38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51
+  };
+  return (c >= '+' && c <= 'z') ? table[c - '+'] : -1;
+}
+
+// Decode base64 text into at most size bytes, 24 bits at a time. Returns the byte count or -1.
+inline int16_t thumb_b64_decode(const char *src, uint8_t *out, const uint16_t size) {
+  uint16_t n = 0;
+  uint32_t acc = 0;
+  uint8_t bits = 0;
+  for (; *src && *src != '=' && *src != '\r' && *src != '\n' && *src != ' '; src++) {
+    const int8_t v = thumb_b64_value(*src);
+    if (v < 0) return -1;
+    acc = (acc << 6) | uint8_t(v);
+    if (++bits == 4) {
+      if (n + 3 > size) return -1;
+      out[n++] = uint8_t(acc >> 16); out[n++] = uint8_t(acc >> 8); out[n++] = uint8_t(acc);
+      acc = bits = 0;
+    }
+  }
+  // Tail of 2 or 3 characters carries 1 or 2 bytes
+  if (bits == 1) return -1;
+  if (bits) {
+    acc <<= 6 * (4 - bits);
+    if (n + bits - 1 > size) return -1;
+    out[n++] = uint8_t(acc >> 16);
+    if (bits == 3) out[n++] = uint8_t(acc >> 8);
+  }
+  return n;
+}
+
+/**
+ * Decode one E3V3SE_THUMB_BIN row into exactly w pixels.
+ * Returns false if the text, the CRC or the pixel count is wrong.
+ */
+inline bool thumb_bin_decode_row(const char *src, uint16_t *px, const uint8_t w) {
+  uint8_t raw[THUMB_BIN_ROW_BYTES];
+  const int16_t n = thumb_b64_decode(src, raw, sizeof(raw));
+  if (n < 3) return false;
+
+  uint16_t crc = 0;
+  crc16(&crc, raw, n - 2);
+  if (crc != ((uint16_t(raw[n - 2]) << 8) | raw[n - 1])) return false;
+
+  const uint8_t *p = raw, * const end = raw + n - 2;
+  uint8_t x = 0;
+  while (p < end) {
+    const uint8_t head = *p++, count = (head & 0x7F) + 1;
+    if (x + count > w) return false;
+    if (head & 0x80) {
+      if (p + 2 > end) return false;
+      const uint16_t color = (uint16_t(p[0]) << 8) | p[1];
+      p += 2;
+      for (uint8_t i = 0; i < count; i++) px[x++] = color;
+    }
+    else {
+      if (p + 2 * count > end) return false;
+      for (uint8_t i = 0; i < count; i++, p += 2) px[x++] = (uint16_t(p[0]) << 8) | p[1];
+    }
+  }
+  return x == w;
+}
+
+/**
+ * E3V3SE_THUMB_HS is the whole RGB565 image (big-endian, row after row)
+ * compressed with heatshrink using the bundled decoder's static window (8)
+ * and lookahead (4), written as base64 lines of whole 3-byte groups:
+ *
+ *   ; E3V3SE_THUMB_HS_BEGIN 96x96
+ *   ; <base64, 76 characters per line>
+ *   ; E3V3SE_THUMB_HS_END
+ *
+ * It is decoded one row at a time, so RAM use is one row plus the decoder.
+ */
+#define THUMB_HS_LINE_BYTES 57
+
+/**
+ * Incremental thumbnail renderer
+ *
+ * Opens the file, locates the header and draws one row per step, yielding
+ * while the panel drains the previous row. task() runs from idle() and
+ * spends at most DWIN_THUMB_SLICE_MS per call, so the file list, encoder
+ * and serial input stay responsive while a preview paints.
+ */
+class ThumbRenderer {
+public:
+  enum State : uint8_t { THUMB_IDLE, THUMB_OPEN, THUMB_HEADER, THUMB_ROWS, THUMB_CLOSE };
+
+  static State state;
+  static uint16_t rows;           // Rows drawn so far
+  static uint32_t slice_max_us,   // Worst-case time spent in a single task() call
+                  slices;         // Number of task() calls that did work
+  static uint32_t click_ms,       // When the file was selected, 0 once the preview is done
+                  preview_ms,     // Selection to finished preview, last file
+                  preview_max_ms; // ...worst case
+
+  static bool busy() { return state != THUMB_IDLE; }
+  static void reset_stats() { slice_max_us = slices = preview_ms = preview_max_ms = 0; }
+
+  // Start the time-to-preview clock
+  static void clicked(const uint32_t ms) { click_ms = ms ?: 1; }
+
+  static void start(const char * const filename);
+  static void abort();
+  static void task();
+
+private:
+  static char fname[13];
+  static uint16_t width, height;
+  static ThumbFormat format;
+  static bool syncing;
+
+  static bool owns_file();
+  static void begin_rows();
+  static int8_t read_row(uint16_t * const row);
+  static bool step();
+  static void finish();
+};
+
+extern ThumbRenderer thumb;
+
+/**
+ * Per-file thumbnail and metadata index
+ *
+ * Remembers where the pixel rows start and what the slicer header said for
+ * the last few files shown, keyed by the directory entry (first cluster, size
+ * and write stamp). Coming back to a file seeks straight to the pixels and
+ * skips both header scans. Entries live in RAM and are dropped with the media.
+ */
+#ifndef DWIN_THUMB_INDEX_SIZE
+  #define DWIN_THUMB_INDEX_SIZE 8
+#endif
+
+typedef struct {
+  uint32_t cluster, size, stamp;  // Key: first cluster, file size, write date/time
+  uint32_t thumb_pos;             // Offset of the first pixel row
+  uint32_t total_time;            // Estimated print time in seconds
+  uint16_t layers;                // Total layer count
+  uint8_t thumb_w, thumb_h;
+  uint8_t thumb_fmt;              // ThumbFormat
+  uint8_t flags;
+  char filament[15], height[15];  // As shown on the preview screen
+} thumb_index_t;
+
+class ThumbIndex {
+public:
+  enum : uint8_t {
+    HAS_META  = 0x01,   // Metadata fields are valid
+    META_OK   = 0x02,   // ...and the parser found a complete header
+    HAS_THUMB = 0x04,   // thumb_pos / thumb_w / thumb_h are valid
+    NO_THUMB  = 0x08    // File was scanned and has no thumbnail
+  };
+
+  static uint16_t hits, misses;   // Counted per file shown, by read_gcode_model_information()
+
+  static thumb_index_t* find(const uint32_t cluster, const uint32_t size, const uint32_t stamp, const bool add);
+  static void clear();
+
+private:
+  static thumb_index_t entry[DWIN_THUMB_INDEX_SIZE];
+  static uint8_t next;
+};
+
+extern ThumbIndex thumb_index;
+
+// Called by the renderer when a preview is complete (or failed)
+void DWIN_ThumbDone(const bool drawn);
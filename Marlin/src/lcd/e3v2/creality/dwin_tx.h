@@ -0,0 +1,85 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+/**
+ * DWIN transmit queue
+ *
+ * Draw commands are appended to a RAM ring and returned from immediately.
+ * pump() hands queued bytes to the UART only as fast as its own interrupt
+ * driven TX buffer has room, so frames from many draw calls go out back to
+ * back without the caller waiting on the wire. Only a full ring makes a
+ * caller wait, and then just for the bytes it needs.
+ *
+ * Header-only and templated on the port so the unit tests can check byte
+ * order and content against a mock.
+ */
+
+#include <stdint.h>
+
+template<typename PORT, uint16_t SIZE>
+class DWINTxQueue {
+  static_assert(SIZE && !(SIZE & (SIZE - 1)), "DWIN TX queue size must be a power of 2.");
+
+  PORT &port;
+  uint8_t buf[SIZE];
+  uint16_t head, tail;    // Write and read indexes
+
+  uint8_t pop() { const uint8_t c = buf[tail]; tail = (tail + 1) & (SIZE - 1); return c; }
+
+public:
+  uint16_t high_water;    // Most bytes ever queued at once
+  uint32_t bytes,         // Total bytes queued
+           stalls;        // Times a writer had to wait for room
+
+  DWINTxQueue(PORT &p) : port(p), head(0), tail(0), high_water(0), bytes(0), stalls(0) {}
+
+  uint16_t used() const { return (head - tail) & (SIZE - 1); }
+  bool empty() const { return head == tail; }
+
+  // Queue one byte, waiting on the port only if the ring is full
+  size_t write(const uint8_t c) {
+    if (used() == SIZE - 1) {
+      stalls++;
+      port.write(pop());
+    }
+    buf[head] = c;
+    head = (head + 1) & (SIZE - 1);
+    bytes++;
+    const uint16_t u = used();
+    if (u > high_water) high_water = u;
+    return 1;
+  }
+
+  // Queue a complete frame
+  void write(const uint8_t *data, uint16_t len) { while (len--) write(*data++); }
+
+  // Move what the port can take without blocking
+  void pump() {
+    for (int n = port.availableForWrite(); n > 0 && !empty(); n--) port.write(pop());
+  }
+
+  // Send everything now
+  void flush() { while (!empty()) port.write(pop()); }
+
+  void reset_stats() { high_water = used(); bytes = stalls = 0; }
+};
@@ -3,6 +3,9 @@
 #define UI_POSITION_H
 
 #if ENABLED(DWIN_CREALITY_480_LCD) //
+//Printing complete
+#define STARVE_SUMMARY_X  12  //Planner starvation summary, below the confirm button at y=283
+#define STARVE_SUMMARY_Y  340
 
 #elif ENABLED(DWIN_CREALITY_320_LCD)//3.2 inch screen
 //Main interface
@@ -266,6 +269,8 @@
 #define CLEAR_50_Y    ICON_SET_Y-1
 #define OK_BUTTON_X   72  //Print completion button location
 #define OK_BUTTON_Y   264
+#define STARVE_SUMMARY_X  12  //Planner starvation summary, below the button
+#define STARVE_SUMMARY_Y  304
 
 //Boot boot, language selection
 #define FIRST_X  20
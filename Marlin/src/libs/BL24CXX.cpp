@@ -30,6 +30,7 @@
  */
 
 #include "BL24CXX.h"
+#include "BL24CXX_page.h"
 #ifdef __STM32F1__
   #include <libmaple/gpio.h>
 #else
@@ -240,6 +241,8 @@ uint8_t IIC::read_byte(unsigned char ack_chr) {
 
 /******************** EEPROM ********************/
 
+typedef BL24CXXPage<IIC, EE_TYPE, EEPROM_DEVICE_ADDRESS> BL24CXXPages;
+
 // Initialize the IIC interface
 void BL24CXX::init() { IIC::init(); }
 
@@ -288,7 +291,7 @@ void BL24CXX::writeOneByte(uint16_t WriteAddr, uint8_t DataToWrite) {
   IIC::send_byte(DataToWrite);                    // Receiving mode
   IIC::wait_ack();
   IIC::stop();                                    // Generate a stop condition
-  delay(10);
+  if (!waitReady()) delay(EEPROM_WRITE_DELAY);    // ACK polling ends as soon as the write cycle does
 }
 
 // Start writing data of length Len at the specified address in BL24CXX
@@ -337,9 +340,9 @@ bool BL24CXX::check() {
 // ReadAddr: The address to start reading is 0~255 for 24c02
 // pBuffer: the first address of the data array
 // NumToRead: the number of data to be read
-void BL24CXX::read(uint16_t ReadAddr, uint8_t *pBuffer, uint16_t NumToRead) {
-  for (; NumToRead; NumToRead--)
-    *pBuffer++ = readOneByte(ReadAddr++);
+// Return: false if the device didn't respond
+bool BL24CXX::read(uint16_t ReadAddr, uint8_t *pBuffer, uint16_t NumToRead) {
+  return BL24CXXPages::read(ReadAddr, pBuffer, NumToRead);
 }
 
 // Start writing the specified number of data at the specified address in BL24CXX
@@ -347,8 +350,34 @@ void BL24CXX::read(uint16_t ReadAddr, uint8_t *pBuffer, uint16_t NumToRead) {
 // pBuffer: the first address of the data array
 // NumToWrite: the number of data to be written
 void BL24CXX::write(uint16_t WriteAddr, uint8_t *pBuffer, uint16_t NumToWrite) {
-  for (; NumToWrite; NumToWrite--, WriteAddr++)
-    writeOneByte(WriteAddr, *pBuffer++);
+  while (NumToWrite) {
+    const uint8_t len = _MIN(NumToWrite, BL24CXX_PAGE_SIZE - WriteAddr % (BL24CXX_PAGE_SIZE));
+    writePage(WriteAddr, pBuffer, len);
+    WriteAddr += len; pBuffer += len; NumToWrite -= len;
+  }
+}
+
+// Write data that doesn't cross a page boundary in one transfer
+// WriteAddr: the address to start writing
+// pBuffer: the data to be written
+// Len: the number of bytes, up to BL24CXX_PAGE_SIZE
+// Return: false if the device didn't respond or finish the write cycle
+bool BL24CXX::writePage(uint16_t WriteAddr, const uint8_t *pBuffer, uint8_t Len) {
+  return BL24CXXPages::writePage(WriteAddr, pBuffer, Len);
 }
 
+// Send data that doesn't cross a page boundary without waiting for the write cycle
+// Return: false if the device didn't respond
+bool BL24CXX::sendPage(uint16_t WriteAddr, const uint8_t *pBuffer, uint8_t Len) {
+  return BL24CXXPages::sendPage(WriteAddr, pBuffer, Len);
+}
+
+// Address the device once
+// Return: false while it is busy with a write cycle
+bool BL24CXX::isReady() { return BL24CXXPages::isReady(); }
+
+// Poll the device with its address until it ACKs
+// Return: false if it stayed busy
+bool BL24CXX::waitReady() { return BL24CXXPages::waitReady(); }
+
 #endif // IIC_BL24CXX_EEPROM
@@ -29,10 +29,12 @@
 /******************** IIC ********************/
 
 class BL24CXX;
+template<typename, uint16_t, uint8_t> class BL24CXXPage;
 
 // All operation functions of IIC
 class IIC {
 friend class BL24CXX;
+template<typename, uint16_t, uint8_t> friend class BL24CXXPage;
 protected:
   static void init();                // Initialize the IO port of IIC
   static void start();               // Send IIC start signal
@@ -68,5 +70,9 @@ public:
   static void writeLenByte(uint16_t WriteAddr, uint32_t DataToWrite, uint8_t Len);  // The specified address begins to write the data of the specified length
   static uint32_t readLenByte(uint16_t ReadAddr, uint8_t Len);                      // The specified address starts to read the data of the specified length
   static void write(uint16_t WriteAddr, uint8_t *pBuffer, uint16_t NumToWrite);     // Write the specified length of data from the specified address
-  static void read(uint16_t ReadAddr, uint8_t *pBuffer, uint16_t NumToRead);        // Read the data of the specified length from the specified address
+  static bool read(uint16_t ReadAddr, uint8_t *pBuffer, uint16_t NumToRead);        // Read the data of the specified length from the specified address
+  static bool writePage(uint16_t WriteAddr, const uint8_t *pBuffer, uint8_t Len);   // Write up to one page in a single transfer and wait for the write cycle
+  static bool sendPage(uint16_t WriteAddr, const uint8_t *pBuffer, uint8_t Len);    // Start a page write without waiting for the write cycle
+  static bool isReady();                                                            // One ACK poll, false while a write cycle is in progress
+  static bool waitReady();                                                          // Poll the device until its write cycle is over
 };
@@ -0,0 +1,355 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2020 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+/**
+ * BL24CXX page transfers and RAM shadow
+ *
+ * BL24CXXPage speaks the 24Cxx protocol a page at a time over an IIC-style
+ * bus: sequential reads of any length, page writes of up to one page, and
+ * ACK polling (re-addressing the chip until it answers) to learn when the
+ * internal write cycle is over, instead of sleeping for the worst case.
+ *
+ * EEPROMShadow keeps the whole image in RAM. Writes only touch the shadow and
+ * mark the pages they change; flush() sends each changed page as a single
+ * write transaction and reads it back to verify it.
+ *
+ * EEPROMSlots keeps two copies of the store, one in each half of the chip,
+ * and commits a new copy to the older half in the background.
+ *
+ * Header-only and templated on the bus so the unit tests can run it against
+ * a simulated chip.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "crc16.h"
+
+#ifndef BL24CXX_PAGE_SIZE
+  #define BL24CXX_PAGE_SIZE 16    // 24C01/02 have 8-byte pages, 24C04-24C16 16, 24C32 and up 32 or more
+#endif
+#ifndef BL24CXX_POLL_TRIES
+  #define BL24CXX_POLL_TRIES 200  // Each poll is a start and a control byte, so this covers a 5ms write cycle
+#endif
+
+/**
+ * BUS provides start(), stop(), send_byte(b), read_byte(ack) and wait_ack(),
+ * with wait_ack() returning nonzero (after sending a stop) if the chip didn't ACK.
+ * LAST is the highest byte address of the chip (EE_TYPE).
+ */
+template<typename BUS, uint16_t LAST, uint8_t DEVICE=0xA0>
+class BL24CXXPage {
+  // Up to 24C16 the top address bits go in the control byte
+  static constexpr bool wide = LAST > 2047;
+  static uint8_t control(const uint16_t addr) { return wide ? DEVICE : DEVICE | ((addr >> 8) << 1); }
+
+  // Start a transfer and set the chip's address pointer. False if the chip didn't answer.
+  static bool address(const uint16_t addr) {
+    BUS::start();
+    BUS::send_byte(control(addr));
+    if (BUS::wait_ack()) return false;
+    if (wide) { BUS::send_byte(addr >> 8); if (BUS::wait_ack()) return false; }
+    BUS::send_byte(addr & 0xFF);
+    return !BUS::wait_ack();
+  }
+
+public:
+  // One ACK poll. False while the chip is busy with a write cycle.
+  static bool isReady() {
+    BUS::start();
+    BUS::send_byte(DEVICE);
+    if (BUS::wait_ack()) return false;
+    BUS::stop();
+    return true;
+  }
+
+  // Poll until the chip ACKs its address, i.e. a write cycle is over
+  static bool waitReady(uint16_t tries=BL24CXX_POLL_TRIES) {
+    while (tries--) if (isReady()) return true;
+    return false;
+  }
+
+  // Read len bytes starting at addr in one transfer
+  static bool read(const uint16_t addr, uint8_t *buf, uint16_t len) {
+    if (!len) return true;
+    if (!address(addr)) return false;
+    BUS::start();
+    BUS::send_byte(control(addr) | 0x01);
+    if (BUS::wait_ack()) return false;
+    while (len--) *buf++ = BUS::read_byte(len != 0);  // NACK the last byte
+    BUS::stop();
+    return true;
+  }
+
+  // Send len bytes that don't cross a page boundary. The chip then starts its write cycle.
+  static bool sendPage(const uint16_t addr, const uint8_t *buf, uint8_t len) {
+    if (!address(addr)) return false;
+    while (len--) {
+      BUS::send_byte(*buf++);
+      if (BUS::wait_ack()) return false;
+    }
+    BUS::stop();
+    return true;
+  }
+
+  // Write a page and wait for the write cycle
+  static bool writePage(const uint16_t addr, const uint8_t *buf, const uint8_t len) {
+    return sendPage(addr, buf, len) && waitReady();
+  }
+};
+
+/**
+ * DEV provides static read(addr, buf, len), writePage(addr, buf, len),
+ * sendPage(addr, buf, len) and isReady(), returning false on a bus error
+ * (or, for isReady(), while a write cycle is in progress).
+ */
+template<typename DEV, uint16_t SIZE, uint8_t PAGE=BL24CXX_PAGE_SIZE>
+class EEPROMShadow {
+  static constexpr uint16_t pages = (SIZE + PAGE - 1) / PAGE;
+
+  uint8_t image[SIZE];
+  uint8_t dirty[(pages + 7) / 8];
+  bool loaded;
+
+  int16_t busy_page;        // Page whose write cycle step() is waiting on, or -1
+  uint16_t polls;
+
+  bool is_dirty(const uint16_t p) const { return dirty[p >> 3] & (1U << (p & 7)); }
+  uint16_t page_addr(const uint16_t p) const { return p * PAGE; }
+  uint8_t page_len(const uint16_t p) const { return (SIZE - p * PAGE < PAGE) ? SIZE - p * PAGE : PAGE; }
+
+  // Read a written page back. Clear its dirty bit if it matches.
+  bool verify(const uint16_t p) {
+    uint8_t check[PAGE];
+    const uint16_t addr = page_addr(p);
+    const uint8_t len = page_len(p);
+    if (DEV::read(addr, check, len) && !memcmp(check, &image[addr], len)) {
+      dirty[p >> 3] &= ~(1U << (p & 7));
+      return true;
+    }
+    verify_errors++;
+    return false;
+  }
+
+public:
+  enum StepResult : uint8_t { FLUSH_DONE, FLUSH_BUSY, FLUSH_ERROR };
+
+  uint16_t pages_written,   // Page transactions sent by flush()
+           verify_errors;   // Pages that didn't read back as written
+
+  EEPROMShadow() : loaded(false), busy_page(-1), pages_written(0), verify_errors(0) { memset(dirty, 0, sizeof(dirty)); }
+
+  bool is_loaded() const { return loaded; }
+
+  // Read the whole chip into RAM once
+  bool load() {
+    if (!loaded) {
+      loaded = DEV::read(0, image, SIZE);
+      memset(dirty, 0, sizeof(dirty));
+    }
+    return loaded;
+  }
+
+  uint8_t read(const uint16_t addr) const { return image[addr]; }
+
+  void write(const uint16_t addr, const uint8_t v) {
+    if (image[addr] == v) return;   // EEPROM has only ~100,000 write cycles, so only write pages that changed
+    image[addr] = v;
+    const uint16_t p = addr / PAGE;
+    dirty[p >> 3] |= 1U << (p & 7);
+  }
+
+  bool pending() const {
+    for (uint8_t i = 0; i < sizeof(dirty); i++) if (dirty[i]) return true;
+    return false;
+  }
+
+  // Write and verify every changed page. Return 'true' on error, like write_data.
+  bool flush() {
+    bool err = false;
+    for (uint16_t p = 0; p < pages; p++) {
+      if (!is_dirty(p)) continue;
+      pages_written++;
+      if (!DEV::writePage(page_addr(p), &image[page_addr(p)], page_len(p))) { verify_errors++; err = true; }
+      else if (!verify(p)) err = true;
+    }
+    return err;
+  }
+
+  /**
+   * Background flush, one bus operation per call, lowest page first:
+   * send a changed page, then poll once per call until its write cycle
+   * is over, then read it back. A failed page stays dirty.
+   */
+  StepResult step() {
+    if (busy_page < 0) {
+      uint16_t p = 0;
+      while (p < pages && !is_dirty(p)) p++;
+      if (p == pages) return FLUSH_DONE;
+      pages_written++;
+      if (!DEV::sendPage(page_addr(p), &image[page_addr(p)], page_len(p))) { verify_errors++; return FLUSH_ERROR; }
+      busy_page = p;
+      polls = 0;
+      return FLUSH_BUSY;
+    }
+    if (!DEV::isReady()) {
+      if (++polls < BL24CXX_POLL_TRIES) return FLUSH_BUSY;
+      busy_page = -1;
+      verify_errors++;
+      return FLUSH_ERROR;
+    }
+    const uint16_t p = busy_page;
+    busy_page = -1;
+    return verify(p) ? FLUSH_BUSY : FLUSH_ERROR;
+  }
+};
+
+/**
+ * Layout of each half for EEPROMSlots. The bytes below the record are left to
+ * code that writes the chip directly (e.g., the DWIN boot step and language)
+ * and are in neither copy. Everything after the record, from the print counter
+ * (STATS_EEPROM_ADDRESS) through the settings, is copied and covered by the CRC.
+ */
+#define EEPROM_SLOT_RECORD  0x20          // Commit record: magic, sequence number, CRC
+#define EEPROM_SLOT_DATA    0x28          // First byte of the copy
+#define EEPROM_SLOT_MAGIC   0x534C4F54UL  // "SLOT"
+
+/**
+ * Two copies of the store, one in each half of the chip. A save is built in
+ * image[], copied into the older half of the shadow by commit() and then
+ * written out by step(), one bus operation per call. The older half's commit
+ * record is cleared first (it is the lowest dirty page) and rewritten with a
+ * new sequence number and the CRC after everything else, so a power loss at
+ * any point leaves the newer half untouched and valid.
+ *
+ * The lower half has the plain layout, so a chip without records loads as is.
+ */
+template<typename DEV, uint16_t SIZE, uint8_t PAGE=BL24CXX_PAGE_SIZE>
+class EEPROMSlots {
+public:
+  typedef EEPROMShadow<DEV, SIZE, PAGE> Shadow;
+  static constexpr uint16_t slot_size = SIZE / 2;
+
+private:
+  struct record_t { uint32_t magic; uint16_t seq, crc; };
+  static_assert(EEPROM_SLOT_DATA == EEPROM_SLOT_RECORD + sizeof(record_t), "EEPROM_SLOT_DATA must follow the commit record.");
+  static_assert(EEPROM_SLOT_RECORD % PAGE == 0, "The commit record must start a page.");
+
+  enum CommitState : uint8_t { COMMIT_IDLE, COMMIT_DATA, COMMIT_RECORD };
+
+  CommitState state;
+  uint16_t commit_crc;
+  bool again;               // Saved again while a commit was running
+
+  static uint16_t slot_base(const uint8_t slot) { return slot * slot_size; }
+
+  static uint16_t image_crc(const uint8_t *data) {
+    uint16_t crc = 0;
+    crc16(&crc, data + EEPROM_SLOT_DATA, slot_size - EEPROM_SLOT_DATA);
+    return crc;
+  }
+
+  // Copy one half of the shadow. Return 'true' if its record and CRC are good.
+  bool read_slot(const uint8_t slot, record_t &rec) {
+    for (uint16_t i = 0; i < slot_size; i++) image[i] = shadow.read(slot_base(slot) + i);
+    memcpy(&rec, image + EEPROM_SLOT_RECORD, sizeof(rec));
+    return rec.magic == EEPROM_SLOT_MAGIC && rec.crc == image_crc(image);
+  }
+
+  void write_record(const uint8_t slot, const record_t &rec) {
+    const uint8_t * const r = (const uint8_t*)&rec;
+    for (uint8_t i = 0; i < sizeof(rec); i++) shadow.write(slot_base(slot) + EEPROM_SLOT_RECORD + i, r[i]);
+  }
+
+  // Stage the image into the older half, unless it matches the newer one
+  void start() {
+    bool same = true;
+    for (uint16_t i = EEPROM_SLOT_DATA; same && i < slot_size; i++)
+      same = image[i] == shadow.read(slot_base(active_slot) + i);
+    if (same) return;
+
+    const uint8_t target = active_slot ^ 1;
+    commit_crc = image_crc(image);
+    write_record(target, { 0, 0, 0 });
+    for (uint16_t i = EEPROM_SLOT_DATA; i < slot_size; i++)
+      shadow.write(slot_base(target) + i, image[i]);
+    state = COMMIT_DATA;
+  }
+
+public:
+  Shadow shadow;
+  uint8_t image[slot_size]; // What the settings code reads and writes
+  uint8_t active_slot;      // Half holding the newest valid copy
+  uint16_t active_seq;      // Its sequence number, 0 if it has no record
+
+  EEPROMSlots() : state(COMMIT_IDLE), again(false), active_slot(0), active_seq(0) {}
+
+  bool is_loaded() const { return shadow.is_loaded(); }
+  bool committing() const { return state != COMMIT_IDLE; }
+
+  // Read the chip and pick the newest valid half, or the lower half of a chip that has no records yet
+  bool load() {
+    if (!shadow.load()) return false;
+    record_t rec[2];
+    bool good[2];
+    good[1] = read_slot(1, rec[1]);
+    good[0] = read_slot(0, rec[0]);
+    active_slot = (good[1] && (!good[0] || int16_t(rec[1].seq - rec[0].seq) > 0)) ? 1 : 0;
+    active_seq = good[active_slot] ? rec[active_slot].seq : 0;
+    if (active_slot) read_slot(1, rec[1]);
+    return true;
+  }
+
+  // Commit the image, or queue it behind the commit that's running
+  void commit() {
+    if (state == COMMIT_IDLE) start(); else again = true;
+  }
+
+  /**
+   * One bus operation of the running commit. FLUSH_BUSY while there's more to do,
+   * FLUSH_DONE once the new half is active. After FLUSH_ERROR the newer half is
+   * still intact and the next commit() tries again.
+   */
+  typename Shadow::StepResult step() {
+    if (state == COMMIT_IDLE) return Shadow::FLUSH_DONE;
+    switch (shadow.step()) {
+      case Shadow::FLUSH_BUSY: return Shadow::FLUSH_BUSY;
+      case Shadow::FLUSH_ERROR: state = COMMIT_IDLE; return Shadow::FLUSH_ERROR;
+      case Shadow::FLUSH_DONE: break;
+    }
+    if (state == COMMIT_DATA) {
+      write_record(active_slot ^ 1, { EEPROM_SLOT_MAGIC, uint16_t(active_seq + 1), commit_crc });
+      state = COMMIT_RECORD;
+      return Shadow::FLUSH_BUSY;
+    }
+    active_slot ^= 1;
+    active_seq++;
+    state = COMMIT_IDLE;
+    if (again) {
+      again = false;
+      start();
+      if (state != COMMIT_IDLE) return Shadow::FLUSH_BUSY;
+    }
+    return Shadow::FLUSH_DONE;
+  }
+};
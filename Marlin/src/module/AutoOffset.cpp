@@ -48,95 +48,128 @@ void HX711::init(int clkPin, int sdoPin)
   CHECK_AND_RUN((!HX711::ckGpioIsInited(clkPin)), {GPIO_SET_MODE(clkPin, 1); GPIO_SET_VAL(clkPin, 0); });
 }
 
+int HX711::ring[HX711_RING_SIZE];
+int32_t HX711::ringZ[HX711_RING_SIZE];
+volatile uint8_t HX711::head, HX711::tail;
+volatile bool HX711::streaming;
+volatile millis_t HX711::lastUseMs;
+HX711 * volatile HX711::active;
+uint32_t HX711::samples, HX711::overruns;
+
+int32_t ProbeTrace::val[AUTOZ_TRACE_SIZE], ProbeTrace::zUm[AUTOZ_TRACE_SIZE];
+uint16_t ProbeTrace::count;
+int32_t ProbeTrace::base;
+int16_t ProbeTrace::minHold, ProbeTrace::maxHold, ProbeTrace::trigger = -1;
+
 /*
- *Function Name: getVal(bool isShowMsg)
- *Purpose: Block and read the pressure value, the maximum blocking time is 20ms
- *Params: (bool)isShowMsg whether to print debugging information
- *Return: (int) the pressure value read
- *Attention: To achieve a sampling rate of 80HZ, ensure that the frequency configuration pin of HX711 has been set to the corresponding level.
+ *Function Name: isr()
+ *Purpose: Clock out a sample as soon as the HX711 has one (SDO low) and queue it
+ *Params: None
+ *Return: None
+ *Attention: Runs from Temperature::isr(). Interrupts are held off only while SCK is high, since a high
+ *           period over 60us powers the chip down. Polling stops HX711_IDLE_MS after the last reader.
  */
-int HX711::getVal(bool isShowMsg)
+void HX711::isr()
 {
-  static unsigned int lastTickMs = 0;
-  int count = 0;
-  unsigned int ms = GET_TICK_MS();
-
-  GPIO_SET_VAL(clkPin, 0);
-
-  while (GPIO_GET_VAL(sdoPin) == 1 && (GET_TICK_MS() - ms <= 20)) // The sampling rate is 80 hz (12ms period), and the maximum delay here is 20ms.
-    MARLIN_CORE_IDLE();
+  if (!streaming) return;
+  if (ELAPSED(millis(), lastUseMs + HX711_IDLE_MS)) { streaming = false; return; }
+  const int clkPin = active->clkPin, sdoPin = active->sdoPin;
+  if (GPIO_GET_VAL(sdoPin) == 1) return;
 
-  DISABLE_ALL_ISR();
+  int count = 0;
   for (int i = 0; i < 24; i++)
   {
+    DISABLE_ALL_ISR();
     GPIO_SET_VAL(clkPin, 1);
     count = count << 1;
     GPIO_SET_VAL(clkPin, 0);
+    ENABLE_ALL_ISR();
     CHECK_AND_RUN((GPIO_GET_VAL(sdoPin) == 1), (count++));
   }
-
+  // 25th pulse selects channel A, gain 128 for the next conversion
+  DISABLE_ALL_ISR();
   GPIO_SET_VAL(clkPin, 1);
   count |= ((count & 0x00800000) != 0 ? 0xFF000000 : 0); // 24-bit signed, converted to 32-bit signed
   GPIO_SET_VAL(clkPin, 0);
   ENABLE_ALL_ISR();
 
-  // CHECK_AND_RUN(isShowMsg, {PRINTF("T=%08d, S=%08d\n", (int)(GET_TICK_MS() -lastTickMs), (int)count);lastTickMs = GET_TICK_MS(); });
-  if (isShowMsg)
-  {
-    lastTickMs = GET_TICK_MS();
-    SERIAL_ECHOLNPGM_P("T=", (int)(GET_TICK_MS() - lastTickMs), ", S=", (int)count);
-  }
-  return count;
+  samples++;
+  const uint8_t next = (head + 1) & (HX711_RING_SIZE - 1);
+  if (next == tail) { overruns++; return; }
+  ring[head] = count;
+  ringZ[head] = stepper.position(Z_AXIS);
+  head = next;
 }
 
 /*
-*Function Name: hFilter(double *vals, int count, double cutFrqHz, double acqFrqHz)
-*Purpose: High-pass filter the data
-*Params: (double*)vals data to be filtered
-                  (int)count length of data to be filtered
-                  (double)cutFrqHz filter cutoff frequency
-*(double)acqFrqHz filter sampling frequency (equivalent to the sampling frequency of HX711 80HZ)
-*Return: None
-*/
-void Filters::hFilter(double *vals, int count, double cutFrqHz, double acqFrqHz)
+ *Function Name: stream()
+ *Purpose: Start polling this HX711 from the ISR, or keep it going for another HX711_IDLE_MS
+ *Params: None
+ *Return: None
+ */
+void HX711::stream()
 {
-  double rc = 1.0f / 2.0f / PI / cutFrqHz;
-  double coff = rc / (rc + 1 / acqFrqHz);
-  double vi = vals[0], viPrev = vals[0], vo = 0, voPrev = 0;
-  FOR_LOOP_TIMES(i, 0, count, {
-    vi = vals[i];
-    vo = (vi - viPrev + voPrev) * coff;
-    voPrev = vo;
-    viPrev = vi;
-    vals[i] = fabs(vo);
-  });
+  lastUseMs = GET_TICK_MS();
+  if (streaming && active == this) return;
+  streaming = false;
+  active = this;
+  flush();
+  streaming = true;
 }
 
 /*
- *Function Name: tFilter(double *vals, int count)
- *Purpose: perform burr filtering on data
- *Params: (double)cutFrqHz filter cutoff frequency
- *(double)acqFrqHz filter sampling frequency (equivalent to the sampling frequency of HX711 80HZ)
- *Return: None
+ *Function Name: read()
+ *Purpose: Take the oldest queued sample
+ *Return: (int) the pressure value
  */
-void Filters::tFilter(double *vals, int count)
+int HX711::read()
 {
-  FOR_LOOP_TIMES(i, 0, count - 3, {
-   double  minVal = (fabs(vals[i]) < fabs(vals[i+1]) ? vals[i] : vals[i+1]);
-    vals[i] = fabs(minVal) < fabs(vals[i+2]) ? minVal : vals[i+2]; });
+  const int val = ring[tail];
+  tail = (tail + 1) & (HX711_RING_SIZE - 1);
+  return val;
 }
 
 /*
-*Function Name: lFilter(double *vals, int count, double k1New)
-*Purpose: Low-pass filter the data
-*Params: (double*)vals data to be filtered
-                  (int)count length of data to be filtered
-                  (double)k1New first-order filter parameters
-*Return: None
-*/
-void Filters::lFilter(double *vals, int count, double k1New)
+ *Function Name: read(int32_t &zSteps)
+ *Purpose: Take the oldest queued sample with the Z stepper position captured when the chip signalled it ready
+ *Params: (int32_t&)zSteps receives the position in steps
+ *Return: (int) the pressure value
+ */
+int HX711::read(int32_t &zSteps)
 {
-  FOR_LOOP_TIMES(i, 1, count, vals[i] = vals[i - 1] * (1 - k1New) + vals[i] * k1New);
+  zSteps = ringZ[tail];
+  return read();
+}
+
+/*
+ *Function Name: getVal(bool isShowMsg)
+ *Purpose: Get the latest pressure value, waiting up to 20ms for the next conversion if none is queued
+ *Params: (bool)isShowMsg whether to print debugging information
+ *Return: (int) the pressure value read
+ *Attention: To achieve a sampling rate of 80HZ, ensure that the frequency configuration pin of HX711 has been set to the corresponding level.
+ *           Like reading the chip directly, this returns the newest conversion and drops any older ones.
+ */
+int HX711::getVal(bool isShowMsg)
+{
+  static unsigned int lastTickMs = 0;
+  static int count = 0;
+  const unsigned int ms = GET_TICK_MS();
+
+  stream();
+
+  while (!available() && (GET_TICK_MS() - ms <= 20)) // The sampling rate is 80 hz (12ms period), and the maximum delay here is 20ms.
+  {
+    lastUseMs = GET_TICK_MS();
+    MARLIN_CORE_IDLE();
+  }
+  while (available()) count = read();
+
+  if (isShowMsg)
+  {
+    SERIAL_ECHOLNPGM_P("T=", (int)(GET_TICK_MS() - lastTickMs), ", S=", count);
+    lastTickMs = GET_TICK_MS();
+  }
+  return count;
 }
 
 /*
@@ -147,18 +180,23 @@ void Filters::lFilter(double *vals, int count, double k1New)
  */
 xyz_long_t ProbeAcq::readBase()
 {
-  static double vals[PI_COUNT / 2] = {0};
-
+  StreamFilter filter;
   double minVal = +0x00FFFFFF, avgVal = 0, maxVal = -0x00FFFFFF; // min avg max
-  FOR_LOOP_TIMES(i, 0, PI_COUNT / 2, { this->hx711.getVal(false); });
-  FOR_LOOP_TIMES(i, 0, PI_COUNT / 2, { vals[i] = this->hx711.getVal(false); });
+  filter.reset(0, LFILTER_K1_NEW);
 
-  Filters::tFilter(vals, PI_COUNT / 2);
-  Filters::lFilter(vals, PI_COUNT / 2, LFILTER_K1_NEW);
-
-  ARY_MIN(minVal, vals, PI_COUNT / 2);
-  ARY_MAX(maxVal, vals, PI_COUNT / 2);
-  ARY_AVG(avgVal, vals, PI_COUNT / 2);
+  // tFilter + lFilter over the window, one sample at a time
+  FOR_LOOP_TIMES(i, 0, PI_COUNT / 2, { this->hx711.getVal(false); });
+  FOR_LOOP_TIMES(i, 0, PI_COUNT / 2, {
+    if (filter.push(this->hx711.getVal(false))) {
+      const double v = filter.committed();
+      NOMORE(minVal, v); NOLESS(maxVal, v); avgVal += v;
+    }
+  });
+  FOR_LOOP_TIMES(i, 0, 3, {
+    const double v = filter.tail(i);
+    NOMORE(minVal, v); NOLESS(maxVal, v); avgVal += v;
+  });
+  avgVal /= PI_COUNT / 2;
 #if ENABLED(SHOW_MSG)
   PRINTF("\n***BASE:MIN=%d, AVG=%d, MAX=%d***\n\n", (int)minVal, (int)avgVal, (int)maxVal);
 #endif
@@ -179,6 +217,25 @@ bool ProbeAcq::checHx711()
   return (abs(bv.x - bv.z) < 100 || abs(bv.x - bv.z) > MIN_HOLD) ? false : true;
 }
 
+/*
+ *Function Name: dump()
+ *Purpose: Print the samples of the last probe, oldest first, for offline replay
+ *Attention: "AZT begin" header, one "AZT,<pressure>,<z um>" line per sample, then "AZT end".
+ *           trig is the line index of the sample that triggered (-1 = none), relative to the first line printed.
+ */
+void ProbeTrace::dump()
+{
+  const uint16_t n = _MIN(count, (uint16_t)AUTOZ_TRACE_SIZE), first = count - n;
+  SERIAL_ECHOLNPGM("AZT begin n=", n, " base=", base, " min=", minHold, " max=", maxHold,
+                   " trig=", trigger < 0 ? -1 : trigger - (int)first, " dropped=", first);
+  for (uint16_t i = 0; i < n; i++) {
+    const uint16_t j = (first + i) % AUTOZ_TRACE_SIZE;
+    SERIAL_ECHOLNPGM("AZT,", val[j], ",", zUm[j]);
+    if ((i & 0x0F) == 0x0F) MARLIN_CORE_IDLE();   // Let the serial buffer drain
+  }
+  SERIAL_ECHOLNPGM("AZT end");
+}
+
 // === Local utilities for median/validation ===
 static inline bool is_valid_offset(const float v) {
   if (isnan(v) || isinf(v)) return false;
@@ -221,9 +278,9 @@ float ProbeAcq::probeTimes(int max_times, xyz_float_t rdy_pos, float step_mm, fl
   pa.maxHold         = max_hold;
 
   FOR_LOOP_TIMES(i, 0, (max_times <= 0 ? 1 : max_times), {
-    mm0 = pa.probePointByStep()->outVal_mm;
+    mm0 = pa.probePoint()->outVal_mm;
     CHECK_AND_RETURN(max_times <= 0, mm0);
-    mm1 = pa.probePointByStep()->outVal_mm;
+    mm1 = pa.probePoint()->outVal_mm;
     CHECK_AND_RETURN(fabs(mm0 - mm1) <= max_z_err, (mm0 + mm1) / 2);
   });
   return (mm0 + mm1) / 2;
@@ -285,90 +342,30 @@ void ProbeAcq::shakeZAxis(int times) {
 
 /*
  *Function Name: calMinZ()
- *Purpose: Calculate the corresponding z-axis height based on the pressure value in the pressure queue after triggering
+ *Purpose: ProbeDetect::calMinZ() with the filtered window and the result printed (SHOW_MSG)
  *Params: None
  *Return: None
  */
 void ProbeAcq::calMinZ()
 {
-  double *valP_t = &this->valP[PI_COUNT]; // rock_ does not start with *2, and the array is out of bounds using 20230204
-  double *posZ_t = &this->posZ[PI_COUNT]; //
-
-  // 1. Filter rock
-  Filters::tFilter(this->valP, PI_COUNT * 2);
-  Filters::hFilter(this->valP, PI_COUNT * 2, RC_CUTE_FRQ, 80);
-  Filters::lFilter(this->valP, PI_COUNT * 2, LFILTER_K1_NEW);
+  this->filterWindow();
 
 #if ENABLED(SHOW_MSG)
+  double *valP_t = &this->valP[PI_COUNT];
+  double *posZ_t = &this->posZ[PI_COUNT];
   PRINTF("%s", "\nx=[");
   FOR_LOOP_TIMES(i, 0, PI_COUNT, PRINTF((i == (PI_COUNT - 1) ? "%s]\n\n" : "%s,"), getStr(posZ_t[i])));
   PRINTF("%s", "y=[");
   FOR_LOOP_TIMES(i, 0, PI_COUNT, PRINTF((i == (PI_COUNT - 1) ? "%s]\n\n" : "%s,"), getStr(valP_t[i])));
 #endif
 
-  // 3. Normalize data to facilitate processing
-  double valMin = +0x00FFFFFF, valMax = -0x00FFFFFF;
-  ARY_MIN(valMin, valP_t, PI_COUNT);
-  ARY_MAX(valMax, valP_t, PI_COUNT);
-  FOR_LOOP_TIMES(i, 0, PI_COUNT, { valP_t[i] = (valP_t[i] - valMin) / (valMax - valMin); });
-
-  // 4. Rotate (slope remove) and find earliest trigger
-  double angle = atan((valP_t[PI_COUNT - 1] - valP_t[0]) / PI_COUNT);
-  double sinAngle = sin(-angle), cosAngle = cos(-angle);
-  FOR_LOOP_TIMES(i, 0, PI_COUNT, valP_t[i] = (i - 0) * sinAngle + (valP_t[i] - 0) * cosAngle + 0);
-
-  // 5. Find minimum index
-  valMin = +0x00FFFFFF;
-  ARY_MIN_INDEX(valMin, this->outIndex, valP_t, PI_COUNT);
-  this->outVal_mm = posZ[this->outIndex + PI_COUNT];
+  this->findMinZ();
+
 #if ENABLED(SHOW_MSG)
   PRINTF("***CalZ Idx=%d, Z=%s***\n", this->outIndex, getStr(this->outVal_mm));
 #endif
 }
 
-/*
- *Function Name: checkTrigger()
- *Purpose: Trigger status detection, used to detect whether the nozzle is in normal contact with the pressure sensor
- *Return: (bool) true=Trigger detected; false=Trigger condition not met.
- */
-bool ProbeAcq::checkTrigger() {
-  // We use a filtered copy (as before) for stability,
-  // but the final criterion is simpler and with fewer restrictions.
-  static double vp_t[PI_COUNT * 2] = {0};
-  static double *valP_t = &vp_t[PI_COUNT];
-
-  // Copy and filters (same as before)
-  FOR_LOOP_TIMES(i, 0, PI_COUNT * 2, vp_t[i] = this->valP[i]);
-  Filters::tFilter(vp_t, PI_COUNT * 2);
-  Filters::hFilter(vp_t, PI_COUNT * 2, RC_CUTE_FRQ, 80);
-  Filters::lFilter(vp_t, PI_COUNT * 2, LFILTER_K1_NEW);
-
-  // 1) We do not treat “reaching the minimum Z” as a trigger.
-  //    The boundary cut is handled by the loop in probePointByStep().
-  //    Here we only detect a REAL contact.
-  //    (No return here.)
-
-  // 2) Sustained overpressure => stop for safety (count it as a late trigger).
-  const int iA = PI_COUNT - 1, iB = PI_COUNT - 2, iC = PI_COUNT - 3;
-  if (abs(valP_t[iA]) > this->maxHold && abs(valP_t[iB]) > this->maxHold && abs(valP_t[iC]) > this->maxHold)
-    return true;
-
-  // 3) Insufficient data
-  if (this->valP[0] == 0) return false;
-
-  // 4) Three last crescents
-  if (!(valP_t[iA] > valP_t[iB] && valP_t[iB] > valP_t[iC])) return false;
-
-  // 5) Minimum threshold (more direct and less strict)
-  //    We ask that the last one pass the threshold and that the previous ones show “rise”.
-  if (abs(valP_t[iA]) < this->minHold) return false;
-
-  // 6) Extra gentle cumulative slope criterion:
-  //    sufficient increase compared to 3 samples ago.
-  if ((valP_t[iA] - valP_t[iC]) < (this->minHold * 0.25)) return false;
-
-  return true;
-}
 
 /*
  *Function Name: probePointByStep()
@@ -409,7 +406,8 @@ ProbeAcq* ProbeAcq::probePointByStep() {
   #endif
 
   // 4) Init colas
-  FOR_LOOP_TIMES(i, 0, PI_COUNT * 2, { this->valP[i] = 0; this->posZ[i] = 0; });
+  this->resetSamples();
+  ProbeTrace::start(unfitAvgVal, *this);
 
   // 5) Step descent (safer: small step and shallow limit)
   const float step_mm = this->step_mm;          // typical 0.02..0.03
@@ -423,13 +421,9 @@ ProbeAcq* ProbeAcq::probePointByStep() {
 
     // Measurement
     const int nowVal = this->hx711.getVal(false);
-    FOR_LOOP_TIMES(i, 0, PI_COUNT * 2 - 1, this->valP[i] = this->valP[i + 1]);
-    FOR_LOOP_TIMES(i, 0, PI_COUNT * 2 - 1, this->posZ[i] = this->posZ[i + 1]);
-    this->valP[PI_COUNT * 2 - 1] = nowVal - unfitAvgVal;
-    this->posZ[PI_COUNT * 2 - 1] = relZ;
 
     // ¿trigger real?
-    if (checkTrigger()) { calMinZ(); break; }
+    if (this->sample(nowVal - unfitAvgVal, relZ)) { calMinZ(); break; }
 
     // Have we reached the travel limit? -> Clean ABORT (without trigger)
     if (relZ <= z_limit) break;
@@ -445,6 +439,76 @@ ProbeAcq* ProbeAcq::probePointByStep() {
   // Note: if there was no trigger, outVal_mm remains 0 (you filter it above with your is_valid_offset)
   return this;
 }
+#if ENABLED(AUTOZ_PROBE_BY_MOVE)
+/*
+ *Function Name: probePointByMove()
+ *Purpose: Continuous-motion measurement and return measurement results.
+ *Params: None
+ *Return: (ProbeAcq) this pointer
+ *Attention: Z descends in a single move at step_mm per HX711 conversion, so the samples are as dense as with
+ *           probePointByStep() but nothing waits for moves to finish. Each sample carries the Z stepper position
+ *           taken when it became ready; a conversion averages the load since the previous one, so the sample
+ *           is placed midway between the two positions. On a trigger the move is aborted like an endstop hit.
+ */
+ProbeAcq* ProbeAcq::probePointByMove() {
+  this->outIndex  = PI_COUNT - 1;
+  this->outVal_mm = 0;
+
+  DO_BLOCKING_MOVE_TO_XY(this->basePos_mm.x, this->basePos_mm.y, this->baseSpdXY_mm_s);
+  DO_BLOCKING_MOVE_TO_Z (this->basePos_mm.z, this->baseSpdZ_mm_s);
+
+  // Baseline, as in probePointByStep()
+  int unfitAvgVal = 0;
+  {
+    const uint8_t S = 8;
+    long acc = 0;
+    FOR_LOOP_TIMES(i, 0, S, { acc += this->hx711.getVal(false); MARLIN_CORE_IDLE(); });
+    unfitAvgVal = (int)(acc / (long)S);
+  }
+
+  #if ENABLED(SOFT_ENDSTOPS)
+    extern bool soft_endstops_enabled;
+    const bool prev_soft = soft_endstops_enabled;
+    soft_endstops_enabled = false;
+  #endif
+
+  this->resetSamples();
+  ProbeTrace::start(unfitAvgVal, *this);
+
+  const int32_t z0 = stepper.position(Z_AXIS);
+  int32_t lastZ = z0;
+  bool hit = false;
+
+  this->hx711.stream();
+  HX711::flush();
+  current_position.z = this->basePos_mm.z + this->minZ_mm;
+  line_to_current_position(this->step_mm * HX711_SPS);
+
+  while (!hit && AXIS_XYZE_STATUS()) {
+    this->hx711.stream();
+    while (HX711::available()) {
+      int32_t zSteps;
+      const int nowVal = HX711::read(zSteps);
+      const double relZ = ((zSteps + lastZ) * 0.5 - z0) * planner.mm_per_step[Z_AXIS];
+      lastZ = zSteps;
+      if (this->sample(nowVal - unfitAvgVal, relZ)) { hit = true; break; }
+    }
+    if (!hit) MARLIN_CORE_IDLE();
+  }
+
+  if (hit) {
+    quickstop_stepper();  // Stop where we are and take the position from the steppers
+    calMinZ();
+  }
+
+  #if ENABLED(SOFT_ENDSTOPS)
+    soft_endstops_enabled = prev_soft;
+  #endif
+
+  return this;
+}
+#endif
+
 /*
  *Function Name: clearByBed(xyz_float_t basePos_mm, float norm, float minTemp, float maxTemp)
  */
@@ -53,10 +53,8 @@
 #define WAIT_HOTEND_TEMP(maxTickMs, maxErr) { unsigned int tickMs = GET_TICK_MS(); while (((GET_TICK_MS() - tickMs) < maxTickMs) && (abs(GET_HOTEND_TAR_TEMP(0) - GET_HOTEND_TEMP(0)) > maxErr)) MARLIN_CORE_IDLE();}
 
 
-#define MIN_HOLD    2000    //Minimum threshold for trigger detection to prevent false triggering
-#define MAX_HOLD    10000   //Maximum threshold for trigger detection to prevent over-triggering
-#define RC_CUTE_FRQ 1     //The cutoff frequency of the RC filter is 0.1~10. The smaller the value = the more sensitive the trigger; the larger the value = the slower the trigger.
-//The slower the speed, the smaller the cutoff frequency
+//MIN_HOLD, MAX_HOLD, RC_CUTE_FRQ, LFILTER_K1_NEW and the trigger detection itself
+#include "AutoOffsetFilter.h"
 
 
 /***The following macro definitions need to be implemented according to different versions of marlin***/
@@ -69,8 +67,6 @@
 //The temperature expansion compensation of the nozzle, that is, the length of the nozzle extension when the temperature is 26 to 200 degrees
 #define NOZ_TEMP_OFT_MM                 0.05
 #define NOZ_AUTO_OFT_MM                 0.02 //0.04
-//low pass filter coefficient
-#define LFILTER_K1_NEW                  0.9f
 //Taking the nozzle as the reference point 0, the installation position of cr touch
 #define CRTOUCH_OFT_POS                 NOZZLE_TO_PROBE_OFFSET
 //The x-direction size of the hot bed, in mm
@@ -190,32 +186,71 @@
   }while(0)
 /***End***/
 
-//RC high-pass filter is used to filter out low-frequency interference such as temperature changes, wire pulling, etc.
-//Glitch filter to remove glitches in continuous data
-//Low-pass filter to remove ultra-high frequency noise from connected data
-class Filters
-{
-  public:
-    static void hFilter(double *vals, int count, double cutFrqHz, double acqFrqHz);
-    static void tFilter(double *vals, int count);
-    static void lFilter(double *vals, int count, double k1New);
-};
+//Number of queued HX711 samples, a power of 2 (16 = 200ms at 80HZ)
+#define HX711_RING_SIZE  16
+//Stop polling the HX711 when no one has asked for a sample for this long
+#define HX711_IDLE_MS    1000
 
-//H x711 chip driver for reading pressure sensor data
+//H x711 chip driver for reading pressure sensor data.
+//Samples are clocked out by Temperature::isr() as soon as the chip has one ready and queued
+//in a single-producer ring, so readers never hold interrupts off while waiting for a conversion.
 class HX711
 {
 public:
   void init(int clkPin, int sdoPin);
   int getVal(bool isShowMsg = 0);
   static bool ckGpioIsInited(int pin);
+
+  static void isr();                          //Called at ~1KHZ from the temperature ISR
+  void stream();                              //Start or keep polling this chip
+  static bool available() { return head != tail; }
+  static int read();                          //Oldest queued sample, call available() first
+  static int read(int32_t &zSteps);           //...and the Z stepper position when it became ready
+  static void flush() { tail = head; }
+
+  static uint32_t samples;                    //Samples clocked out
+  static uint32_t overruns;                   //Samples dropped because the ring was full
 private:
   int clkPin;
   int sdoPin;
+
+  static int ring[HX711_RING_SIZE];
+  static int32_t ringZ[HX711_RING_SIZE];
+  static volatile uint8_t head, tail;         //head is written by the ISR only, tail by readers only
+  static volatile bool streaming;
+  static volatile millis_t lastUseMs;
+  static HX711 * volatile active;             //The instance whose pins the ISR reads
 };
 
-#define PI_COUNT 32
+//Samples of the last probe, kept for G212 D and the replay tests
+#define AUTOZ_TRACE_SIZE 256
 
-class ProbeAcq
+class ProbeTrace
+{
+  public:
+    static int32_t val[AUTOZ_TRACE_SIZE];   //Pressure with the baseline removed
+    static int32_t zUm[AUTOZ_TRACE_SIZE];   //Z relative to the start position, in microns
+    static uint16_t count;                  //Samples recorded, the newest AUTOZ_TRACE_SIZE are kept
+    static int32_t base;                    //Baseline that was removed
+    static int16_t minHold, maxHold;        //Thresholds the probe ran with
+    static int16_t trigger;                 //Sample that triggered, or -1
+
+    static void start(int32_t base, const ProbeDetect &pd)
+    {
+      ProbeTrace::base = base; minHold = pd.minHold; maxHold = pd.maxHold;
+      count = 0; trigger = -1;
+    }
+    static void add(int32_t v, float z)
+    {
+      const uint16_t i = count % AUTOZ_TRACE_SIZE;
+      val[i] = v; zUm[i] = (int32_t)lroundf(z * 1000);
+      count++;
+    }
+    static void hit() { trigger = count - 1; }
+    static void dump();                     //Print as CSV for the replay tests
+};
+
+class ProbeAcq : public ProbeDetect
 {
   public:
     float baseSpdXY_mm_s;       //The preparation speed of the nozzle moving in the x and y planes
@@ -223,26 +258,27 @@ class ProbeAcq
     float minZ_mm;              //The stop position when moving towards the z-axis, that is, when no pressure change is detected when reaching this position, it will be forced to stop.
 
     float step_mm;              //Every time this distance is moved, the pressure sensor is read
-    int   minHold;              //Minimum threshold, the last point of the trigger condition needs to be greater than this value
-    int   maxHold;              //Maximum threshold. If the last point of the trigger condition is greater than this value, the trigger is forced.
-
-    float outVal_mm;            //Output, the corresponding axis coordinate when triggered
-    int   outIndex;             //Output, the corresponding sequence index when triggered. If the value is not in the (PI_COUNT*2/3, PI_COUNT-1) interval, the measurement is wrong and needs to be measured again.
 
     xyz_float_t basePos_mm;     //That is, the coordinates of the preparation position that the nozzle needs to reach before starting to measure this point.
     
     HX711 hx711;                //Point to acquisition function for CS123X or HX711
     ProbeAcq* probePointByStep();   //Test this against the parameter configuration of this class
+    ProbeAcq* probePointByMove();   //Same, with one continuous Z move and the trigger checked as samples arrive
+    ProbeAcq* probePoint() { return TERN(AUTOZ_PROBE_BY_MOVE, probePointByMove(), probePointByStep()); }
     xyz_long_t readBase();      //Get clean data   
     bool checHx711();           //Check whether the pressure sensor is working properly
     void shakeZAxis(int times); //Vibrate the z-axis to eliminate gap stress
     static float probeTimes(int max_times, xyz_float_t rdy_pos, float step_mm, float min_dis_mm, float max_z_err, int min_hold, int max_hold);
   private:
-    double valP[PI_COUNT * 2];  //The pressure value of the pressure saving sequence
-    double posZ[PI_COUNT * 2];  //The corresponding coordinate values ​​of the pressure saving sequence
-    
-    void calMinZ();             //Calculate measurement results based on pressure saving sequence
-    bool checkTrigger();        //Check whether the data in the pressure saving sequence meets the trigger conditions
+    void calMinZ();             //ProbeDetect::calMinZ() with the SHOW_MSG diagnostics
+    bool sample(double val, double z) //Record and push a sample, true when it triggers
+    {
+      ProbeTrace::add((int32_t)val, z);
+      this->pushSample(val, z);
+      if (!this->checkTrigger()) return false;
+      ProbeTrace::hit();
+      return true;
+    }
 };
 char *getStr(float f);
 void gcodeG212();
@@ -0,0 +1,327 @@
+/*
+*Assignment: AutoOffset pressure filters
+*Description: The window filters used by the CR-TOUCH automatic Z-OFFSET (Filters) and single-precision
+*             streaming versions that give the same outputs for a window's newest samples in O(1) per sample.
+*             ProbeDetect is the trigger detection and trigger height calculation run on those samples.
+*Attention: Header-only so the unit tests can compare both, and replay recorded traces (G212 D) through the
+*           same detection code the printer runs.
+*/
+#pragma once
+
+#include <math.h>
+#include <stdint.h>
+
+#define PI_COUNT    32      //Samples used by calMinZ(); the window holds twice as many
+#define MIN_HOLD    2000    //Minimum threshold for trigger detection to prevent false triggering
+#define MAX_HOLD    10000   //Maximum threshold for trigger detection to prevent over-triggering
+#define RC_CUTE_FRQ 1     //The cutoff frequency of the RC filter is 0.1~10. The smaller the value = the more sensitive the trigger; the larger the value = the slower the trigger.
+//The slower the speed, the smaller the cutoff frequency
+//low pass filter coefficient
+#define LFILTER_K1_NEW  0.9f
+//HX711 conversions per second (RATE pin high)
+#define HX711_SPS       80
+
+//RC high-pass filter is used to filter out low-frequency interference such as temperature changes, wire pulling, etc.
+//Glitch filter to remove glitches in continuous data
+//Low-pass filter to remove ultra-high frequency noise from connected data
+class Filters
+{
+  public:
+    /*
+    *Function Name: hFilter(double *vals, int count, double cutFrqHz, double acqFrqHz)
+    *Purpose: High-pass filter the data
+    *Params: (double*)vals data to be filtered
+    *        (int)count length of data to be filtered
+    *        (double)cutFrqHz filter cutoff frequency
+    *        (double)acqFrqHz filter sampling frequency (equivalent to the sampling frequency of HX711 80HZ)
+    *Return: None
+    */
+    static void hFilter(double *vals, int count, double cutFrqHz, double acqFrqHz)
+    {
+      double coff = coefficient(cutFrqHz, acqFrqHz);
+      double vi = vals[0], viPrev = vals[0], vo = 0, voPrev = 0;
+      for (int i = 0; i < count; i++) {
+        vi = vals[i];
+        vo = (vi - viPrev + voPrev) * coff;
+        voPrev = vo;
+        viPrev = vi;
+        vals[i] = fabs(vo);
+      }
+    }
+
+    /*
+    *Function Name: tFilter(double *vals, int count)
+    *Purpose: perform burr filtering on data, keeping the smallest magnitude of each sample and the next two
+    *Params: (double*)vals data to be filtered
+    *        (int)count length of data to be filtered, the last three samples are left as they are
+    *Return: None
+    */
+    static void tFilter(double *vals, int count)
+    {
+      for (int i = 0; i < count - 3; i++) {
+        double minVal = (fabs(vals[i]) < fabs(vals[i+1]) ? vals[i] : vals[i+1]);
+        vals[i] = fabs(minVal) < fabs(vals[i+2]) ? minVal : vals[i+2];
+      }
+    }
+
+    /*
+    *Function Name: lFilter(double *vals, int count, double k1New)
+    *Purpose: Low-pass filter the data
+    *Params: (double*)vals data to be filtered
+    *        (int)count length of data to be filtered
+    *        (double)k1New first-order filter parameters
+    *Return: None
+    */
+    static void lFilter(double *vals, int count, double k1New)
+    {
+      for (int i = 1; i < count; i++) vals[i] = vals[i - 1] * (1 - k1New) + vals[i] * k1New;
+    }
+
+    //RC high-pass coefficient for a cutoff and sampling frequency
+    static double coefficient(double cutFrqHz, double acqFrqHz)
+    {
+      double rc = 1.0 / 2.0 / 3.14159265358979323846 / cutFrqHz;
+      return rc / (rc + 1 / acqFrqHz);
+    }
+};
+
+/*
+*Class Name: StreamFilter
+*Purpose: tFilter, then hFilter (optional), then lFilter, one sample at a time in single precision
+*Attention: Like tFilter on a window, the newest three samples skip the burr filter. push() feeds the
+*           filtered state with the sample three back, which is final once its two successors are known,
+*           and tail(i) runs the raw newest three on a copy of that state. A window started at the first
+*           sample gives the same outputs; a sliding window differs only by how the high-pass started,
+*           which has decayed by coff^61 (<1%) at the newest samples.
+*/
+class StreamFilter
+{
+  public:
+    //coff = Filters::coefficient(), or 0 for no high-pass; k1New as for lFilter
+    void reset(float coff, float k1New)
+    {
+      this->coff = coff;
+      this->k1New = k1New;
+      this->count = 0;
+      this->state = { 0, 0, 0 };  //count guards these, but a filter in a local must not start from garbage
+      for (uint8_t i = 0; i < 3; i++) this->raw[i] = this->tails[i] = 0;
+    }
+
+    //Add a sample. Returns true if a settled output (committed()) was produced.
+    bool push(float v)
+    {
+      bool out = false;
+      if (this->count >= 3) {
+        const float t = absMin(absMin(this->raw[0], this->raw[1]), this->raw[2]);
+        this->state = step(this->state, t, this->count == 3);
+        out = true;
+      }
+      this->raw[0] = this->raw[1]; this->raw[1] = this->raw[2]; this->raw[2] = v;
+      this->count++;
+
+      // The newest three, raw, continue from the settled state
+      State s = this->state;
+      const uint8_t first = this->count < 3 ? 3 - this->count : 0;   // Oldest valid entry of raw[]
+      for (uint8_t i = first; i < 3; i++) {
+        s = step(s, this->raw[i], this->count <= 3 && i == first);
+        this->tails[2 - i] = s.lp;
+      }
+      return out;
+    }
+
+    //Settled output of the sample three back (valid after push() returned true)
+    float committed() const { return this->state.lp; }
+    //Output for the newest samples as the end of the window: 0=newest, 1, 2
+    float tail(uint8_t i) const { return this->tails[i]; }
+    uint32_t samples() const { return this->count; }
+
+  private:
+    struct State { float hpIn, hpOut, lp; };
+
+    float coff, k1New;
+    float raw[3];               //Newest three samples, oldest first
+    State state;                //Filters after the last settled sample
+    float tails[3];
+    uint32_t count;
+
+    static float absMin(float a, float b) { return fabsf(a) < fabsf(b) ? a : b; }
+
+    State step(State s, float v, bool first) const
+    {
+      float h = v;
+      if (this->coff > 0) {
+        if (first) s.hpOut = 0;
+        else s.hpOut = (v - s.hpIn + s.hpOut) * this->coff;
+        s.hpIn = v;
+        h = fabsf(s.hpOut);
+      }
+      s.lp = first ? h : s.lp * (1 - this->k1New) + h * this->k1New;
+      return s;
+    }
+};
+
+/*
+*Class Name: ProbeDetect
+*Purpose: The window of samples taken while the nozzle moves down, trigger detection on it, and the
+*         trigger height calculation. The thresholds and filter settings are members so a replay can sweep them.
+*/
+class ProbeDetect
+{
+  public:
+    int   minHold;              //Minimum threshold, the last point of the trigger condition needs to be greater than this value
+    int   maxHold;              //Maximum threshold. If the last point of the trigger condition is greater than this value, the trigger is forced.
+    float cutFrqHz;             //High-pass cutoff frequency (RC_CUTE_FRQ)
+    float k1New;                //Low-pass coefficient (LFILTER_K1_NEW)
+
+    float outVal_mm;            //Output, the corresponding axis coordinate when triggered
+    int   outIndex;             //Output, the corresponding sequence index when triggered. If the value is not in the (PI_COUNT*2/3, PI_COUNT-1) interval, the measurement is wrong and needs to be measured again.
+
+    ProbeDetect() : minHold(MIN_HOLD), maxHold(MAX_HOLD), cutFrqHz(RC_CUTE_FRQ), k1New(LFILTER_K1_NEW), outVal_mm(0), outIndex(0) { resetSamples(); }
+
+    /*
+    *Function Name: resetSamples()
+    *Purpose: Empty the windows and restart the trigger filters
+    */
+    void resetSamples()
+    {
+      for (int i = 0; i < PI_COUNT * 2; i++) { this->valP[i] = 0; this->posZ[i] = 0; }
+      this->winHead = 0;
+      this->trigFilter.reset(Filters::coefficient(this->cutFrqHz, HX711_SPS), this->k1New);
+    }
+
+    /*
+    *Function Name: pushSample(double val, double z)
+    *Purpose: Add a sample to the circular windows, replacing the oldest one
+    */
+    void pushSample(double val, double z)
+    {
+      this->trigFilter.push(val);
+      this->valP[this->winHead] = val;
+      this->posZ[this->winHead] = z;
+      this->winHead = (this->winHead + 1) & (PI_COUNT * 2 - 1);
+    }
+
+    /*
+    *Function Name: checkTrigger()
+    *Purpose: Trigger status detection, used to detect whether the nozzle is in normal contact with the pressure sensor
+    *Return: (bool) true=Trigger detected; false=Trigger condition not met.
+    */
+    bool checkTrigger()
+    {
+      // The filtered newest three samples, as the end of the window (despike, high-pass, low-pass).
+      // trigFilter keeps them up to date as samples are pushed, so nothing is re-filtered here.
+      const double vA = this->trigFilter.tail(0), vB = this->trigFilter.tail(1), vC = this->trigFilter.tail(2);
+
+      // 1) We do not treat “reaching the minimum Z” as a trigger.
+      //    The boundary cut is handled by the loop in probePointByStep().
+      //    Here we only detect a REAL contact.
+      //    (No return here.)
+
+      // 2) Sustained overpressure => stop for safety (count it as a late trigger).
+      if (fabs(vA) > this->maxHold && fabs(vB) > this->maxHold && fabs(vC) > this->maxHold)
+        return true;
+
+      // 3) Insufficient data
+      if (this->valAt(0) == 0) return false;
+
+      // 4) Three last crescents
+      if (!(vA > vB && vB > vC)) return false;
+
+      // 5) Minimum threshold (more direct and less strict)
+      //    We ask that the last one pass the threshold and that the previous ones show “rise”.
+      if (fabs(vA) < this->minHold) return false;
+
+      // 6) Extra gentle cumulative slope criterion:
+      //    sufficient increase compared to 3 samples ago.
+      if ((vA - vC) < (this->minHold * 0.25)) return false;
+
+      return true;
+    }
+
+    /*
+    *Function Name: calMinZ()
+    *Purpose: Calculate the corresponding z-axis height based on the pressure value in the pressure queue after triggering
+    *Params: None
+    *Return: None
+    */
+    void calMinZ()
+    {
+      this->filterWindow();
+      this->findMinZ();
+    }
+
+    /*
+    *Function Name: replay(const float *val, const float *z, int count)
+    *Purpose: Run a recorded probe through the detection as probePointByStep() would
+    *Params: (const float*)val pressure samples with the baseline removed
+    *        (const float*)z the Z position of each sample
+    *        (int)count number of samples
+    *Return: (int) index of the sample that triggered (outVal_mm/outIndex are then set), or -1
+    */
+    int replay(const float *val, const float *z, int count)
+    {
+      this->resetSamples();
+      for (int i = 0; i < count; i++) {
+        this->pushSample(val[i], z[i]);
+        if (this->checkTrigger()) { this->calMinZ(); return i; }
+      }
+      return -1;
+    }
+
+  protected:
+    //Circular windows: the oldest sample is at winHead, new samples overwrite it
+    double valP[PI_COUNT * 2];  //The pressure value of the pressure saving sequence
+    double posZ[PI_COUNT * 2];  //The corresponding coordinate values ​​of the pressure saving sequence
+    uint8_t winHead;
+
+    StreamFilter trigFilter;    //The trigger filters, updated as each sample is pushed
+
+    double valAt(int i) const { return this->valP[(this->winHead + i) & (PI_COUNT * 2 - 1)]; }
+
+    //calMinZ() step 1: put the window in time order and filter it. The newest PI_COUNT samples are then used.
+    void filterWindow()
+    {
+      this->unwindSamples();
+
+      // 1. Filter rock
+      Filters::tFilter(this->valP, PI_COUNT * 2);
+      Filters::hFilter(this->valP, PI_COUNT * 2, this->cutFrqHz, HX711_SPS);
+      Filters::lFilter(this->valP, PI_COUNT * 2, this->k1New);
+    }
+
+    //calMinZ() steps 3-5: find where the filtered pressure starts to rise and take its Z
+    void findMinZ()
+    {
+      double *valP_t = &this->valP[PI_COUNT]; // rock_ does not start with *2, and the array is out of bounds using 20230204
+
+      // 3. Normalize data to facilitate processing
+      double valMin = +0x00FFFFFF, valMax = -0x00FFFFFF;
+      for (int i = 0; i < PI_COUNT; i++) { if (valP_t[i] < valMin) valMin = valP_t[i]; if (valP_t[i] > valMax) valMax = valP_t[i]; }
+      for (int i = 0; i < PI_COUNT; i++) valP_t[i] = (valP_t[i] - valMin) / (valMax - valMin);
+
+      // 4. Rotate (slope remove) and find earliest trigger
+      double angle = atan((valP_t[PI_COUNT - 1] - valP_t[0]) / PI_COUNT);
+      double sinAngle = sin(-angle), cosAngle = cos(-angle);
+      for (int i = 0; i < PI_COUNT; i++) valP_t[i] = (i - 0) * sinAngle + (valP_t[i] - 0) * cosAngle + 0;
+
+      // 5. Find minimum index
+      valMin = +0x00FFFFFF;
+      for (int i = 0; i < PI_COUNT; i++) if (valMin >= valP_t[i]) { valMin = valP_t[i]; this->outIndex = i; }
+      this->outVal_mm = this->posZ[this->outIndex + PI_COUNT];
+    }
+
+    static void reverseVals(double *vals, int from, int to)
+    {
+      for (--to; from < to; from++, to--) { double t = vals[from]; vals[from] = vals[to]; vals[to] = t; }
+    }
+
+    //Put the windows back in time order, oldest first
+    void unwindSamples()
+    {
+      const int n = PI_COUNT * 2, k = this->winHead;
+      if (k == 0) return;
+      double *ary[2] = {this->valP, this->posZ};
+      for (int a = 0; a < 2; a++) { reverseVals(ary[a], 0, k); reverseVals(ary[a], k, n); reverseVals(ary[a], 0, n); }
+      this->winHead = 0;
+    }
+};
@@ -113,6 +113,14 @@
   #include "../feature/spindle_laser.h"
 #endif
 
+#if ENABLED(MOTION_BENCHMARK)
+  #include "../HAL/LINUX/hardware/Clock.h"
+#endif
+
+#if ENABLED(PLANNER_STARVATION_PROFILE)
+  #include "../feature/starvation.h"
+#endif
+
 // Delay for delivery of first block to the stepper ISR, if the queue contains 2 or
 // fewer movements. The delay is measured in milliseconds, and must be less than 250ms
 #define BLOCK_DELAY_NONE         0U
@@ -132,6 +140,12 @@ volatile uint8_t Planner::block_buffer_head,    // Index of the next block to be
 uint16_t Planner::cleaning_buffer_counter;      // A counter to disable queuing of blocks
 uint8_t Planner::delay_before_delivering;       // Delay block delivery so initial blocks in an empty queue may merge
 
+#if ENABLED(MOTION_BENCHMARK)
+  void (*Planner::bench_drain)();
+  uint64_t Planner::bench_reverse_ns, Planner::bench_forward_ns;
+  uint32_t Planner::bench_recalcs;
+#endif
+
 #if ENABLED(EDITABLE_STEPS_PER_UNIT)
   float Planner::mm_per_step[DISTINCT_AXES];    // (mm) Millimeters per step
 #else
@@ -764,12 +778,15 @@ block_t* Planner::get_current_block() {
     // As this block is busy, advance the nonbusy block pointer
     block_buffer_nonbusy = next_block_index(block_buffer_tail);
 
+    TERN_(PLANNER_STARVATION_PROFILE, starvation_profile.block_started(block->millimeters, block->nominal_speed));
+
     // Return the block
     return block;
   }
 
   // The queue became empty
   TERN_(HAS_WIRED_LCD, clear_block_buffer_runtime()); // paranoia. Buffer is empty now - so reset accumulated time to zero.
+  TERN_(PLANNER_STARVATION_PROFILE, starvation_profile.ran_dry());
 
   return nullptr;
 }
@@ -1178,9 +1195,19 @@ void Planner::recalculate_trapezoids(const float safe_exit_speed_sqr) {
 
 // Requires there's at least one block with flag.recalculate in the buffer
 void Planner::recalculate(const float safe_exit_speed_sqr) {
-  reverse_pass(safe_exit_speed_sqr);
-  // The forward pass is done as part of recalculate_trapezoids()
-  recalculate_trapezoids(safe_exit_speed_sqr);
+  #if ENABLED(MOTION_BENCHMARK)
+    const uint64_t t0 = Clock::nanos();
+    reverse_pass(safe_exit_speed_sqr);
+    const uint64_t t1 = Clock::nanos();
+    recalculate_trapezoids(safe_exit_speed_sqr);
+    bench_reverse_ns += t1 - t0;
+    bench_forward_ns += Clock::nanos() - t1;
+    bench_recalcs++;
+  #else
+    reverse_pass(safe_exit_speed_sqr);
+    // The forward pass is done as part of recalculate_trapezoids()
+    recalculate_trapezoids(safe_exit_speed_sqr);
+  #endif
 }
 
 /**
@@ -460,6 +460,13 @@ class Planner {
     static uint16_t cleaning_buffer_counter;        // A counter to disable queuing of blocks
     static uint8_t delay_before_delivering;         // This counter delays delivery of blocks when queue becomes empty to allow the opportunity of merging blocks
 
+    #if ENABLED(MOTION_BENCHMARK)
+      static void (*bench_drain)();                 // Called instead of idle() to run the steppers while the queue is full
+      static uint64_t bench_reverse_ns,             // Time spent in reverse_pass()
+                      bench_forward_ns;             // Time spent in recalculate_trapezoids(), which does the forward pass
+      static uint32_t bench_recalcs;                // Calls to recalculate()
+    #endif
+
     #if ENABLED(DISTINCT_E_FACTORS)
       static uint8_t last_extruder;                 // Respond to extruder change
     #endif
@@ -878,7 +885,7 @@ class Planner {
     FORCE_INLINE static block_t* get_next_free_block(uint8_t &next_buffer_head, const uint8_t count=1) {
 
       // Wait until there are enough slots free
-      while (moves_free() < count) { idle(); }
+      while (moves_free() < count) { TERN(MOTION_BENCHMARK, bench_drain(), idle()); }
 
       // Return the first available block
       next_buffer_head = next_block_index(block_buffer_head);
@@ -32,6 +32,7 @@
 
 #include "../libs/buzzer.h"
 #include "motion.h"
+#include "planner.h"
 #include "temperature.h"
 #include "endstops.h"
 
@@ -1078,6 +1079,93 @@ float Probe::probe_at_point(
   return measured_z;
 }
 
+#if ENABLED(BLTOUCH_FAST_MESH)
+
+  /**
+   * @brief Probe one point of a fast G29 mesh
+   *
+   * @details Lift straight off the last point by BLTOUCH_FAST_MESH_LIFT, then travel
+   *          to the new XY and rise to the "between" clearance as a single move.
+   *          The pin stays deployed (HIGH SPEED mode). Probe once at the fast rate, and
+   *          only probe again slowly if the result misses predicted_z by more than
+   *          BLTOUCH_FAST_MESH_TOLERANCE. No raise afterwards; the next point does it.
+   *
+   * @param pos           Probe XY
+   * @param predicted_z   Expected bed Z from the points probed so far, or NAN to always probe twice
+   * @param reprobed      Set if the slow probe was needed
+   *
+   * @return The bed Z at the probe or NAN on error, with the probe stowed
+   */
+  float Probe::probe_mesh_point(const xy_pos_t &pos, const float predicted_z, bool &reprobed, const uint8_t verbose_level/*=0*/) {
+    DEBUG_SECTION(log_probe, "Probe::probe_mesh_point", DEBUGGING(LEVELING));
+
+    reprobed = false;
+
+    const float z_clearance = Z_TWEEN_SAFE_CLEARANCE;
+    xyz_pos_t npos = { pos.x, pos.y, _MAX(current_position.z, z_clearance) };
+    if (!can_reach(npos)) {
+      if (DEBUGGING(LEVELING)) DEBUG_ECHOLNPGM("Not Reachable");
+      return NAN;
+    }
+    npos -= offset_xy;
+
+    // Clear the pin off the bed, then travel and raise together
+    if (current_position.z < z_clearance)
+      do_blocking_move_to_z(_MIN(current_position.z + (BLTOUCH_FAST_MESH_LIFT), z_clearance), z_probe_fast_mm_s);
+    current_position = npos;
+    line_to_current_position(XY_PROBE_FEEDRATE_MM_S);
+    planner.synchronize();
+
+    TERN_(PROBING_USE_CURRENT_HOME, set_homing_current(Z_AXIS));
+
+    // An alarm or a stow left over from the last point, as in probe_at_point()
+    if (bltouch.triggered()) bltouch._reset();
+
+    const float zoffs = SUM_TERN(HAS_HOTEND_OFFSET, -offset.z, hotend_offset[active_extruder].z),
+                z_low = zoffs + (Z_PROBE_LOW_POINT) - float((!axis_is_trusted(Z_AXIS)) * 10);
+
+    auto probe_down = [&](const feedRate_t fr_mm_s) {
+      return probe_down_to_z(z_low, fr_mm_s) || current_position.z > zoffs + (Z_PROBE_ERROR_TOLERANCE);
+    };
+
+    float measured_z = NAN;
+    if (!deploy() && !probe_down(z_probe_fast_mm_s)) {
+      const float z1 = current_position.z;
+      if (!isnan(predicted_z) && ABS(z1 + offset.z - predicted_z) <= (BLTOUCH_FAST_MESH_TOLERANCE))
+        measured_z = z1;
+      else {
+        // Off the prediction (or nothing to predict from): a slow probe as run_z_probe() does
+        reprobed = true;
+        do_z_clearance(z1 + (Z_CLEARANCE_MULTI_PROBE), false);
+        if (!probe_down(z_probe_slow_mm_s)) {
+          if (DEBUGGING(LEVELING)) DEBUG_ECHOLNPGM("2nd Probe Z:", current_position.z, " Discrepancy:", z1 - current_position.z);
+          measured_z = (current_position.z * 3.0f + z1 * 2.0f) * 0.2f;
+        }
+      }
+    }
+
+    if (isnan(measured_z)) {
+      stow();
+      LCD_MESSAGE(MSG_LCD_PROBING_FAILED);
+      #if DISABLED(G29_RETRY_AND_RECOVER)
+        SERIAL_ERROR_MSG(STR_ERR_PROBING_FAILED);
+      #endif
+    }
+    else {
+      measured_z = DIFF_TERN(HAS_HOTEND_OFFSET, measured_z, hotend_offset[active_extruder].z) + offset.z;
+      TERN_(HAS_PTC, ptc.apply_compensation(measured_z));
+      TERN_(X_AXIS_TWIST_COMPENSATION, measured_z += xatc.compensation(npos + offset_xy));
+      if (verbose_level > 2 || DEBUGGING(LEVELING))
+        SERIAL_ECHOLNPGM("Bed X: ", LOGICAL_X_POSITION(pos.x), " Y: ", LOGICAL_Y_POSITION(pos.y), " Z: ", measured_z, reprobed ? " (2 probes)" : "");
+    }
+
+    TERN_(PROBING_USE_CURRENT_HOME, restore_homing_current(Z_AXIS));
+
+    return measured_z;
+  }
+
+#endif // BLTOUCH_FAST_MESH
+
 #if HAS_Z_SERVO_PROBE
 
   void Probe::servo_probe_init() {
@@ -197,6 +197,10 @@ public:
       return probe_at_point(pos.x, pos.y, raise_after, verbose_level, probe_relative, sanity_check, z_min_point, z_clearance, raise_after_is_rel);
     }
 
+    #if ENABLED(BLTOUCH_FAST_MESH)
+      static float probe_mesh_point(const xy_pos_t &pos, const float predicted_z, bool &reprobed, const uint8_t verbose_level=0);
+    #endif
+
   #else // !HAS_BED_PROBE
 
     static constexpr xyz_pos_t offset = xyz_pos_t(NUM_AXIS_ARRAY_1(0)); // See #16767
@@ -850,6 +850,20 @@ void MarlinSettings::postprocess() {
                 "ARCHIM2_SPI_FLASH_EEPROM_BACKUP_SIZE is insufficient to capture all EEPROM data.");
 #endif
 
+#if ENABLED(EEPROM_ASYNC_COMMIT)
+  #include "../libs/BL24CXX_page.h"
+  static_assert(EEPROM_OFFSET + sizeof(SettingsData) <= (MARLIN_EEPROM_SIZE) / 2,
+                "EEPROM_ASYNC_COMMIT keeps a copy in each half of the EEPROM. MARLIN_EEPROM_SIZE / 2 is insufficient for the settings.");
+  #if ENABLED(PRINTCOUNTER)
+    static_assert(STATS_EEPROM_ADDRESS >= EEPROM_SLOT_DATA,
+                  "EEPROM_ASYNC_COMMIT only copies data from EEPROM_SLOT_DATA up. STATS_EEPROM_ADDRESS is below it.");
+  #endif
+  // M936 writes its flag straight to the chip, inside the slot, so the next load fails the CRC and rolls back
+  #if ENABLED(OTA_FIRMWARE_UPDATE)
+    #error "OTA_FIRMWARE_UPDATE is not compatible with EEPROM_ASYNC_COMMIT."
+  #endif
+#endif
+
 //
 // This file simply uses the DEBUG_ECHO macros to implement EEPROM_CHITCHAT.
 // For deeper debugging of EEPROM issues enable DEBUG_EEPROM_READWRITE.
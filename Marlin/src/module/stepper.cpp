@@ -127,6 +127,12 @@ Stepper stepper; // Singleton
   #include "../HAL/ESP32/i2s.h"
 #endif
 
+#if ENABLED(STEPPER_ISR_PROFILE)
+  #include "../feature/stepper_profile.h"
+#else
+  #define ISR_PROFILE(P, CODE) CODE
+#endif
+
 // public:
 
 #if ANY(HAS_EXTRA_ENDSTOPS, Z_STEPPER_AUTO_ALIGN)
@@ -1494,6 +1500,8 @@ HAL_STEP_TIMER_ISR() {
 
 void Stepper::isr() {
 
+  TERN_(STEPPER_ISR_PROFILE, const uint32_t isr_start = StepperProfile::now());
+
   static hal_timer_t nextMainISR = 0;  // Interval until the next main Stepper Pulse phase (0 = Now)
 
   #if ENABLED(SMOOTH_LIN_ADVANCE)
@@ -1509,7 +1517,8 @@ void Stepper::isr() {
   hal_timer_t next_isr_ticks = 0;
 
   // Limit the amount of iterations
-  uint8_t max_loops = 10;
+  constexpr uint8_t loop_limit = 10;
+  uint8_t max_loops = loop_limit;
 
   #if ENABLED(FT_MOTION)
     static uint32_t ftMotion_nextStepperISR = 0U;  // Storage for the next ISR for stepping.
@@ -1551,11 +1560,11 @@ void Stepper::isr() {
 
       TERN_(HAS_ZV_SHAPING, shaping_isr());               // Do Shaper stepping, if needed
 
-      if (!nextMainISR) pulse_phase_isr();                // 0 = Do coordinated axes Stepper pulses
+      if (!nextMainISR) ISR_PROFILE(ISR_PULSE, pulse_phase_isr()); // 0 = Do coordinated axes Stepper pulses
 
       #if ENABLED(LIN_ADVANCE)
         if (!nextAdvanceISR) {                            // 0 = Do Linear Advance E Stepper pulses
-          advance_isr();
+          ISR_PROFILE(ISR_ADVANCE, advance_isr());
           nextAdvanceISR = la_interval;
         }
         else if (nextAdvanceISR > la_interval)            // Start/accelerate LA steps if necessary
@@ -1572,7 +1581,7 @@ void Stepper::isr() {
 
       // ^== Time critical. NOTHING besides pulse generation should be above here!!!
 
-      if (!nextMainISR) nextMainISR = block_phase_isr();  // Manage acc/deceleration, get next block
+      if (!nextMainISR) ISR_PROFILE(ISR_BLOCK, nextMainISR = block_phase_isr()); // Manage acc/deceleration, get next block
       #if ENABLED(SMOOTH_LIN_ADVANCE)
         if (!smoothLinAdvISR) smoothLinAdvISR = smooth_lin_adv_isr();  // Manage la
       #endif
@@ -1676,10 +1685,13 @@ void Stepper::isr() {
     if (next_isr_ticks < min_ticks) {
       next_isr_ticks = min_ticks;
 
+      TERN_(STEPPER_ISR_PROFILE, StepperProfile::data.late++);
+
       // When forced out of the ISR, increase multi-stepping
       #if MULTISTEPPING_LIMIT > 1
         if (steps_per_isr < MULTISTEPPING_LIMIT) {
           steps_per_isr <<= 1;
+          TERN_(STEPPER_ISR_PROFILE, StepperProfile::data.ms_up++);
           // ticks_nominal will need to be recalculated if we are in cruise phase
           ticks_nominal = 0;
         }
@@ -1699,6 +1711,8 @@ void Stepper::isr() {
   // Set the next ISR to fire at the proper time
   HAL_timer_set_compare(MF_TIMER_STEP, next_isr_ticks);
 
+  TERN_(STEPPER_ISR_PROFILE, StepperProfile::isr_done(isr_start, steps_per_isr, loop_limit - max_loops));
+
   // Don't forget to finally reenable interrupts on non-AVR.
   // AVR automatically calls sei() for us on Return-from-Interrupt.
   #ifndef __AVR__
@@ -2384,6 +2398,7 @@ hal_timer_t Stepper::block_phase_isr() {
     #if MULTISTEPPING_LIMIT > 1
       if (steps_per_isr > 1 && time_spent_out_isr >= time_spent_in_isr + time_spent) {
         steps_per_isr >>= 1;
+        TERN_(STEPPER_ISR_PROFILE, StepperProfile::data.ms_down++);
         // ticks_nominal will need to be recalculated if we are in cruise phase
         ticks_nominal = 0;
       }
@@ -2695,6 +2710,8 @@ hal_timer_t Stepper::block_phase_isr() {
         }
       #endif
 
+      TERN_(STEPPER_ISR_PROFILE, StepperProfile::block_started(oversampling_factor));
+
       // Based on the oversampling factor, do the calculations
       step_event_count = current_block->step_event_count << oversampling_factor;
 
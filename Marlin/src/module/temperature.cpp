@@ -219,6 +219,10 @@
   #include "../feature/e_parser.h"
 #endif
 
+#if ENABLED(USE_AUTOZ_TOOL_2)
+  #include "AutoOffset.h"
+#endif
+
 #if ENABLED(PRINTER_EVENT_LEDS)
   #include "../feature/leds/printer_event_leds.h"
 #endif
@@ -4408,6 +4412,9 @@ void Temperature::isr() {
   #endif
   if (do_buttons) ui.update_buttons();
 
+  // Collect a load cell sample whenever one is ready
+  TERN_(USE_AUTOZ_TOOL_2, HX711::isr());
+
   /**
    * One sensor is sampled on every other call of the ISR.
    * Each sensor is read 16 (OVERSAMPLENR) times, taking the average.
@@ -0,0 +1,196 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2024 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * SDIO read-ahead
+ *
+ * A read that follows on from the previous one starts a CMD18 multi-block read
+ * of the next SDIO_READ_AHEAD_BLOCKS blocks into one half of a double buffer.
+ * Once reads move into that half the other half is loaded with the blocks after
+ * it, so a sequential reader (a print) finds its blocks already in RAM and the
+ * card transfers in the background while the previous buffer is consumed.
+ *
+ * Anything else (FAT and directory reads, seeks) is read on demand as before,
+ * after any transfer in flight has landed. A write drops only a half holding
+ * the written block, so occasional writes (e.g., the power-loss journal) don't
+ * throw away the read-ahead of the file being printed.
+ *
+ * Between writeStart() and writeStop() the same halves carry a CMD25 stream:
+ * writeData() stages blocks in one half while the other is being written.
+ * Other reads and writes in the meantime first send whatever they would
+ * otherwise overtake.
+ */
+
+#include "../inc/MarlinConfig.h"
+
+#if NEED_SD2CARD_SDIO && ENABLED(SDIO_READ_AHEAD)
+
+#include "Sd2Card_sdio.h"
+
+bool DiskIODriver_SDIO::init(const uint8_t, const pin_t) {
+  wait();
+  invalidate();
+  streaming = false;
+  last_direct = 0;
+  return SDIO_Init();
+}
+
+// Finish the transfer in flight, if any. Return false while it's still running.
+bool DiskIODriver_SDIO::poll() {
+  if (loading < 0) return true;
+  const int8_t r = SDIO_Blocks_Poll();
+  if (!r) return false;
+  if (writing)
+    write_failed |= r < 0;
+  else {
+    stats.busy_us += micros() - load_start_us;
+    if (r > 0) {
+      half[loading].ready = true;
+      stats.bytes_streamed += sizeof(buffer[0]);
+    }
+  }
+  if (r < 0) stats.errors++;
+  loading = -1;
+  writing = false;
+  return true;
+}
+
+// Block until the transfer in flight has landed
+void DiskIODriver_SDIO::wait() {
+  if (loading < 0) return;
+  const uint32_t t = micros();
+  while (!poll()) { /* DMA */ }
+  stats.wait_us += micros() - t;
+}
+
+// Start filling a half with the blocks from 'first' on
+void DiskIODriver_SDIO::load(const uint8_t h, const uint32_t first) {
+  half[h].ready = false;
+  half[h].first = first;
+  if (SDIO_ReadBlocks_Start(first, buffer[h], SDIO_READ_AHEAD_BLOCKS)) {
+    loading = h;
+    load_start_us = micros();
+  }
+}
+
+bool DiskIODriver_SDIO::readBlock(uint32_t block, uint8_t *dst) {
+  // Staged blocks are newer than the card's copy
+  if (streaming && block - curBlock < staged && !flush()) return false;
+
+  poll();
+
+  for (uint8_t h = 0; h < 2; ++h) {
+    const uint32_t i = block - half[h].first;
+    if (i >= SDIO_READ_AHEAD_BLOCKS || !(half[h].ready || (loading == h && !writing))) continue;
+    if (loading == h) {
+      stats.stalls++;
+      wait();
+      if (!half[h].ready) break;
+    }
+    memcpy(dst, buffer[h] + i * 512, 512);
+    stats.blocks_ahead++;
+
+    // Reading from this half, so bring in the blocks that follow it
+    const uint8_t o = h ^ 1;
+    const uint32_t next = half[h].first + SDIO_READ_AHEAD_BLOCKS;
+    if (loading < 0 && !streaming && !(half[o].ready && half[o].first == next)) load(o, next);
+    return true;
+  }
+
+  // Not buffered. Let any read-ahead land, then read the block on demand.
+  wait();
+  const uint32_t t = micros();
+  const bool ok = SDIO_ReadBlock(block, dst);
+  stats.wait_us += micros() - t;
+  if (!ok) return false;
+  stats.blocks_direct++;
+
+  // A second block in sequence starts the read-ahead
+  if (block == last_direct + 1 && !streaming) load(0, block + 1);
+  last_direct = block;
+  return true;
+}
+
+bool DiskIODriver_SDIO::writeBlock(uint32_t block, const uint8_t *src) {
+  if (streaming && !flush()) return false;
+  wait();                                                 // One transfer at a time
+  for (uint8_t h = 0; h < 2; ++h)
+    if (block - half[h].first < SDIO_READ_AHEAD_BLOCKS) half[h].ready = false;
+  return SDIO_WriteBlock(block, src);
+}
+
+// Send the staged blocks with CMD25 and stage into the other half
+bool DiskIODriver_SDIO::flush() {
+  if (!staged) return !write_failed;
+  wait();                                                 // One transfer at a time
+  if (!write_failed && !SDIO_WriteBlocks_Start(curBlock, buffer[stage], staged)) write_failed = true;
+  if (write_failed) return false;
+  loading = stage;
+  writing = true;
+  stats.blocks_written += staged;
+  curBlock += staged;
+  staged = 0;
+  stage ^= 1;
+  return true;
+}
+
+bool DiskIODriver_SDIO::writeStart(const uint32_t block, const uint32_t) {
+  if (streaming && !writeStop()) return false;
+  wait();
+  invalidate();
+  curBlock = block;
+  staged = stage = 0;
+  write_failed = false;
+  return (streaming = true);
+}
+
+bool DiskIODriver_SDIO::writeData(const uint8_t *src) {
+  if (!streaming || write_failed) return false;
+  memcpy(buffer[stage] + staged * 512, src, 512);
+  return ++staged < SDIO_READ_AHEAD_BLOCKS || flush();
+}
+
+bool DiskIODriver_SDIO::writeStop() {
+  if (!streaming) return true;
+  flush();
+  wait();
+  streaming = false;
+  return !write_failed;
+}
+
+void DiskIODriver_SDIO::reset_stats() {
+  stats = {};
+  stats.since = millis();
+}
+
+void DiskIODriver_SDIO::report_stats() {
+  const uint32_t blocks = stats.blocks_ahead + stats.blocks_direct,
+                 span = _MAX(millis() - stats.since, 1UL),
+                 card_kbs = stats.busy_us ? uint32_t(stats.bytes_streamed * 1000000ULL / 1024 / stats.busy_us) : 0,
+                 read_kbs = uint32_t(uint64_t(blocks) * 512 * 1000 / 1024 / span);
+  SERIAL_ECHOLNPGM("SD blocks read:", blocks, " ahead:", stats.blocks_ahead, " direct:", stats.blocks_direct,
+                   " stalls:", stats.stalls, " written:", stats.blocks_written, " errors:", stats.errors);
+  SERIAL_ECHOLNPGM("SD card sustained:", card_kbs, "KB/s read:", read_kbs, "KB/s waited:",
+                   uint32_t(stats.wait_us / 1000), "ms over ", span, "ms");
+}
+
+#endif // NEED_SD2CARD_SDIO && SDIO_READ_AHEAD
@@ -32,9 +32,33 @@ bool SDIO_WriteBlock(uint32_t block, const uint8_t *src);
 bool SDIO_IsReady();
 uint32_t SDIO_GetCardSize();
 
+#if ENABLED(SDIO_READ_AHEAD)
+
+  bool SDIO_ReadBlocks_Start(uint32_t block, uint8_t *dst, uint16_t count);
+  bool SDIO_WriteBlocks_Start(uint32_t block, const uint8_t *src, uint16_t count);
+  int8_t SDIO_Blocks_Poll();
+
+  typedef struct {
+    uint32_t blocks_ahead,    // Blocks served from the read-ahead buffer
+             blocks_direct,   // Blocks read on demand
+             stalls,          // Reads that had to wait for their read-ahead to land
+             blocks_written,  // Blocks sent by multi-block writes
+             errors;          // Failed multi-block transfers
+    uint64_t bytes_streamed,  // Bytes brought in by read-ahead
+             busy_us,         // Time read-ahead transfers were in flight
+             wait_us;         // Time readers spent blocked on the card
+    millis_t since;
+  } sdio_read_stats_t;
+
+#endif
+
 class DiskIODriver_SDIO : public DiskIODriver {
   public:
-    bool init(const uint8_t sckRateID=0, const pin_t chipSelectPin=0) override { return SDIO_Init(); }
+    #if ENABLED(SDIO_READ_AHEAD)
+      bool init(const uint8_t sckRateID=0, const pin_t chipSelectPin=0) override;
+    #else
+      bool init(const uint8_t sckRateID=0, const pin_t chipSelectPin=0) override { return SDIO_Init(); }
+    #endif
 
     bool readCSD(csd_t *csd)                              override { return false; }
 
@@ -42,18 +66,64 @@ class DiskIODriver_SDIO : public DiskIODriver {
     bool readData(uint8_t *dst)                           override { return readBlock(curBlock++, dst); }
     bool readStop()                                       override { curBlock = -1; return true; }
 
-    bool writeStart(const uint32_t block, const uint32_t) override { curBlock = block; return true; }
-    bool writeData(const uint8_t *src)                    override { return writeBlock(curBlock++, src); }
-    bool writeStop()                                      override { curBlock = -1; return true; }
-
-    bool readBlock(uint32_t block, uint8_t *dst)          override { return SDIO_ReadBlock(block, dst); }
-    bool writeBlock(uint32_t block, const uint8_t *src)   override { return SDIO_WriteBlock(block, src); }
+    #if ENABLED(SDIO_READ_AHEAD)
+      bool writeStart(const uint32_t block, const uint32_t) override;
+      bool writeData(const uint8_t *src)                    override;
+      bool writeStop()                                      override;
+    #else
+      bool writeStart(const uint32_t block, const uint32_t) override { curBlock = block; return true; }
+      bool writeData(const uint8_t *src)                    override { return writeBlock(curBlock++, src); }
+      bool writeStop()                                      override { curBlock = -1; return true; }
+    #endif
 
     uint32_t cardSize()                                   override { return SDIO_GetCardSize(); }
 
-    bool isReady()                                        override { return SDIO_IsReady(); }
+    #if ENABLED(SDIO_READ_AHEAD)
+
+      bool readBlock(uint32_t block, uint8_t *dst)        override;
+      bool writeBlock(uint32_t block, const uint8_t *src) override;
+
+      bool isReady()                                      override { return loading >= 0 || SDIO_IsReady(); }
+
+      void idle()                                         override { poll(); }
+
+      // No transfer in flight, so the next block written won't have to wait
+      bool writeReady() { return poll(); }
+
+      sdio_read_stats_t stats;
+      void reset_stats();
+      void report_stats();
+
+    #else
+
+      bool readBlock(uint32_t block, uint8_t *dst)        override { return SDIO_ReadBlock(block, dst); }
+      bool writeBlock(uint32_t block, const uint8_t *src) override { return SDIO_WriteBlock(block, src); }
+
+      bool isReady()                                      override { return SDIO_IsReady(); }
+
+      void idle()                                         override {}
+
+    #endif
 
-    void idle()                                           override {}
   private:
     uint32_t curBlock;
+
+    #if ENABLED(SDIO_READ_AHEAD)
+      // Two halves: one is read from while CMD18 fills the other with the blocks that follow.
+      // Between writeStart() and writeStop() one half is filled while CMD25 sends the other.
+      alignas(32) uint8_t buffer[2][SDIO_READ_AHEAD_BLOCKS * 512];  // Cache-line aligned for DMA on F7/H7
+      struct { uint32_t first; bool ready; } half[2];
+      int8_t loading = -1;                                // Half with a transfer in flight, or -1
+      bool writing = false,                               // The transfer in flight is a write
+           streaming = false,                             // Between writeStart() and writeStop()
+           write_failed = false;
+      uint8_t staged, stage;                              // Blocks waiting in the staging half, and which half
+      uint32_t load_start_us, last_direct = 0;
+
+      bool poll();
+      void wait();
+      void load(const uint8_t h, const uint32_t first);
+      bool flush();
+      void invalidate() { half[0].ready = half[1].ready = false; }
+    #endif
 };
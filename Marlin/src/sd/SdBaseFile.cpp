@@ -140,6 +140,61 @@ bool SdBaseFile::contiguousRange(uint32_t * const bgnBlock, uint32_t * const end
   return false;
 }
 
+#if ENABLED(SD_EXTENT_MAP)
+
+  /**
+   * Map the runs of consecutive clusters in a file opened for read, so read()
+   * and seekSet() can find a cluster without following the chain in the FAT.
+   * Clusters past the last run that fits in \a map are still found in the FAT.
+   *
+   * \param[out] map Storage for the runs. Must stay valid while the file is open.
+   * \param[in] size The number of runs \a map can hold.
+   *
+   * \return true for success, false for failure.
+   * Reasons for failure include the file is not a normal file open for read only,
+   * the chain is shorter than the file or an I/O error occurred.
+   */
+  bool SdBaseFile::mapExtents(sd_extent_t * const map, const uint8_t size) {
+    extentCount_ = 0;
+    if (!isFile() || (flags_ & O_WRITE) || firstCluster_ == 0 || size == 0) return false;
+
+    const uint8_t shift = vol_->clusterSizeShift_ + 9;
+    const uint32_t clusters = (fileSize_ + (1UL << shift) - 1) >> shift;
+    uint8_t n = 0;
+    uint32_t c = firstCluster_;
+    map[0].cluster = c;
+    for (uint32_t i = 1; i < clusters; ++i) {
+      uint32_t next;
+      if (!vol_->fatGet(c, &next) || vol_->isEOC(next)) return false;
+      if (next != c + 1) {
+        map[n].end = i;
+        if (++n == size) break;
+        map[n].cluster = next;
+      }
+      c = next;
+    }
+    if (n < size) map[n++].end = clusters;
+
+    extents_ = map;
+    extentCount_ = n;
+    return true;
+  }
+
+  // Get the cluster at a cluster index in the file, if it's mapped
+  bool SdBaseFile::mappedCluster(const uint32_t index, uint32_t * const cluster) const {
+    uint32_t start = 0;
+    for (uint8_t i = 0; i < extentCount_; ++i) {
+      if (index < extents_[i].end) {
+        *cluster = extents_[i].cluster + (index - start);
+        return true;
+      }
+      start = extents_[i].end;
+    }
+    return false;
+  }
+
+#endif // SD_EXTENT_MAP
+
 /**
  * Create and open a new contiguous file of a specified size.
  *
@@ -180,6 +235,39 @@ bool SdBaseFile::createContiguous(SdBaseFile * const dirFile, const char * const
   return sync();
 }
 
+#if ENABLED(BINARY_STREAM_UPLOAD)
+
+  /**
+   * Give an empty file opened for write a contiguous run of clusters.
+   *
+   * The file takes the full \a size so the run can be written block by block
+   * without walking the FAT. Use truncate() to give back the part not written.
+   *
+   * \param[in] size The number of bytes to reserve.
+   * \param[out] bgnBlock The first block of the run.
+   *
+   * \return true for success, false for failure.
+   * Reasons for failure include the file is not empty or not open
+   * for write, there is no free run of that size or an I/O error.
+   */
+  bool SdBaseFile::preAllocate(const uint32_t size, uint32_t * const bgnBlock) {
+    if (ENABLED(SDCARD_READONLY)) return false;
+
+    if (!size || !isFile() || !(flags_ & O_WRITE) || firstCluster_) return false;
+
+    const uint32_t count = ((size - 1) >> (vol_->clusterSizeShift_ + 9)) + 1;
+    if (!vol_->allocContiguous(count, &firstCluster_)) return false;
+    fileSize_ = size;
+
+    // insure sync() will update dir entry
+    flags_ |= F_FILE_DIR_DIRTY;
+
+    *bgnBlock = vol_->clusterStartBlock(firstCluster_);
+    return sync();
+  }
+
+#endif
+
 /**
  * Return a file's directory entry.
  *
@@ -942,6 +1030,7 @@ bool SdBaseFile::openCachedEntry(const uint8_t dirIndex, const uint8_t oflag) {
   // set to start of file
   curCluster_ = 0;
   curPosition_ = 0;
+  TERN_(SD_EXTENT_MAP, extentCount_ = 0);
   if ((oflag & O_TRUNC) && !truncate(0)) return false;
   return oflag & O_AT_END ? seekEnd(0) : true;
 
@@ -1263,6 +1352,7 @@ bool SdBaseFile::openRoot(SdVolume *vol) {
 
   // set to start of file
   curCluster_ = curPosition_ = 0;
+  TERN_(SD_EXTENT_MAP, extentCount_ = 0);
 
   // root has no directory entry
   dirBlock_ = dirIndex_ = 0;
@@ -1392,7 +1482,8 @@ int16_t SdBaseFile::read(void * const buf, uint16_t nbyte) {
         // start of new cluster
         if (curPosition_ == 0)
           curCluster_ = firstCluster_;                      // use first cluster in file
-        else if (!vol_->fatGet(curCluster_, &curCluster_))  // get next cluster from FAT
+        else if (TERN1(SD_EXTENT_MAP, !mappedCluster(curPosition_ >> (vol_->clusterSizeShift_ + 9), &curCluster_))
+              && !vol_->fatGet(curCluster_, &curCluster_))  // get next cluster from the extent map or FAT
           return -1;
       }
       block = vol_->clusterStartBlock(curCluster_) + blockOfCluster;
@@ -1934,6 +2025,22 @@ bool SdBaseFile::seekSet(const uint32_t pos) {
   nCur = (curPosition_ - 1) >> (vol_->clusterSizeShift_ + 9);
   nNew = (pos - 1) >> (vol_->clusterSizeShift_ + 9);
 
+  #if ENABLED(SD_EXTENT_MAP)
+    if (mappedCluster(nNew, &curCluster_)) {
+      curPosition_ = pos;
+      return true;
+    }
+    if (extentCount_) {
+      // past the map so follow the chain from its last cluster, or from curPosition if further along
+      const uint32_t nLast = extents_[extentCount_ - 1].end - 1;
+      if (nNew < nCur || curPosition_ == 0 || nCur < nLast) {
+        mappedCluster(nLast, &curCluster_);
+        nCur = nLast;
+      }
+      nNew -= nCur;
+    }
+    else
+  #endif
   if (nNew < nCur || curPosition_ == 0)
     curCluster_ = firstCluster_;      // must follow chain from first cluster
   else
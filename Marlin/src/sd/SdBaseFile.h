@@ -72,6 +72,17 @@ uint8_t const T_ACCESS = 1,   // Set the file's last access date
               T_CREATE = 2,   // Set the file's creation date and time
               T_WRITE = 4;    // Set the file's write date and time
 
+#if ENABLED(SD_EXTENT_MAP)
+  /**
+   * \struct sd_extent_t
+   * \brief A run of consecutive clusters in a file
+   */
+  struct sd_extent_t {
+    uint32_t cluster; // first cluster of the run
+    uint32_t end;     // index in the file of the cluster after the run
+  };
+#endif
+
 // values for type_
 uint8_t const FAT_FILE_TYPE_CLOSED = 0,                           // This file has not been opened.
               FAT_FILE_TYPE_NORMAL = 1,                           // A normal file
@@ -189,6 +200,9 @@ class SdBaseFile {
   bool close();
   bool contiguousRange(uint32_t * const bgnBlock, uint32_t * const endBlock);
   bool createContiguous(SdBaseFile * const dirFile, const char * const path, const uint32_t size);
+  #if ENABLED(BINARY_STREAM_UPLOAD)
+    bool preAllocate(const uint32_t size, uint32_t * const bgnBlock);
+  #endif
   /**
    * \return The current cluster number for a file or directory.
    */
@@ -284,6 +298,9 @@ class SdBaseFile {
   bool getDosName(char * const name);
   void ls(const uint8_t flags=0, const uint8_t indent=0);
 
+  #if ENABLED(SD_EXTENT_MAP)
+    bool mapExtents(sd_extent_t * const map, const uint8_t size);
+  #endif
   bool mkdir(SdBaseFile *parent, const char *path, const bool pFlag=true);
   bool open(SdBaseFile * const dirFile, uint16_t index, const uint8_t oflag);
   bool open(SdBaseFile * const dirFile, const char *path, const uint8_t oflag);
@@ -368,6 +385,10 @@ class SdBaseFile {
   uint32_t  fileSize_;      // file size in bytes
   uint32_t  firstCluster_;  // first cluster of file
   SdVolume  *vol_;          // volume where file is located
+  #if ENABLED(SD_EXTENT_MAP)
+    const sd_extent_t *extents_;  // cluster runs from mapExtents()
+    uint8_t extentCount_ = 0;     // number of runs mapped, 0 if none
+  #endif
 
   /**
    * EXPERIMENTAL - Don't use!
@@ -378,6 +399,9 @@ class SdBaseFile {
   bool addCluster();
   bool addDirCluster();
   dir_t* cacheDirEntry(const uint8_t action);
+  #if ENABLED(SD_EXTENT_MAP)
+    bool mappedCluster(const uint32_t index, uint32_t * const cluster) const;
+  #endif
   int8_t lsPrintNext(const uint8_t flags, const uint8_t indent);
   static bool make83Name(const char *str, uint8_t * const name, const char **ptr);
   bool mkdir(SdBaseFile * const parent, const uint8_t dname[11]
@@ -44,6 +44,10 @@
   DiskIODriver *SdVolume::sdCard_;       // pointer to SD card object
   bool     SdVolume::cacheDirty_;        // cacheFlush() will write block if true
   uint32_t SdVolume::cacheMirrorBlock_;  // mirror  block for second FAT
+  #if ENABLED(SD_FAT_CACHE)
+    cache_t  SdVolume::fatCache_;            // 512 byte read cache for FAT blocks
+    uint32_t SdVolume::fatCacheBlockNumber_; // block number in the FAT cache
+  #endif
 #endif
 
 // find a contiguous group of clusters
@@ -144,10 +148,20 @@ bool SdVolume::cacheRawBlock(const uint32_t blockNumber, const bool dirty) {
     if (!sdCard_->readBlock(blockNumber, cacheBuffer_.data)) return false;
     cacheBlockNumber_ = blockNumber;
   }
-  if (dirty) cacheDirty_ = true;
+  if (dirty) {
+    cacheDirty_ = true;
+    TERN_(SD_FAT_CACHE, fatCacheDrop(blockNumber));
+  }
   return true;
 }
 
+#if ENABLED(SD_FAT_CACHE)
+  // The FAT cache is never dirty. Drop a block from it when it's modified in the main cache.
+  void SdVolume::fatCacheDrop(const uint32_t blockNumber) {
+    if (blockNumber == fatCacheBlockNumber_) fatCacheBlockNumber_ = 0xFFFFFFFF;
+  }
+#endif
+
 // return the size in bytes of a cluster chain
 bool SdVolume::chainSize(uint32_t cluster, uint32_t * const size) {
   uint32_t s = 0;
@@ -187,10 +201,24 @@ bool SdVolume::fatGet(const uint32_t cluster, uint32_t * const value) {
   else
     return false;
 
-  if (lba != cacheBlockNumber_ && !cacheRawBlock(lba, CACHE_FOR_READ))
-    return false;
+  #if ENABLED(SD_FAT_CACHE)
+    // Read through the FAT cache so following a chain doesn't evict file data
+    // and directory entries. A block in the main cache may be newer, so use it.
+    const cache_t *fat = &cacheBuffer_;
+    if (lba != cacheBlockNumber_) {
+      if (lba != fatCacheBlockNumber_) {
+        if (!sdCard_->readBlock(lba, fatCache_.data)) return false;
+        fatCacheBlockNumber_ = lba;
+      }
+      fat = &fatCache_;
+    }
+    *value = (fatType_ == 16) ? fat->fat16[cluster & 0xFF] : (fat->fat32[cluster & 0x7F] & FAT32MASK);
+  #else
+    if (lba != cacheBlockNumber_ && !cacheRawBlock(lba, CACHE_FOR_READ))
+      return false;
 
-  *value = (fatType_ == 16) ? cacheBuffer_.fat16[cluster & 0xFF] : (cacheBuffer_.fat32[cluster & 0x7F] & FAT32MASK);
+    *value = (fatType_ == 16) ? cacheBuffer_.fat16[cluster & 0xFF] : (cacheBuffer_.fat32[cluster & 0x7F] & FAT32MASK);
+  #endif
   return true;
 }
 
@@ -336,6 +364,7 @@ bool SdVolume::init(DiskIODriver * const dev, const uint8_t part) {
   cacheDirty_ = 0;  // cacheFlush() will write block if true
   cacheMirrorBlock_ = 0;
   cacheBlockNumber_ = 0xFFFFFFFF;
+  TERN_(SD_FAT_CACHE, fatCacheBlockNumber_ = 0xFFFFFFFF);
 
   // if part == 0 assume super floppy with FAT boot sector in block zero
   // if part > 0 assume mbr volume with partition table
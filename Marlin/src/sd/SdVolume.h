@@ -80,6 +80,7 @@ class SdVolume {
   cache_t* cacheClear() {
     if (!cacheFlush()) return 0;
     cacheBlockNumber_ = 0xFFFFFFFF;
+    TERN_(SD_FAT_CACHE, fatCacheBlockNumber_ = 0xFFFFFFFF);
     return &cacheBuffer_;
   }
 
@@ -144,12 +145,20 @@ class SdVolume {
     DiskIODriver *sdCard_;       // DiskIODriver object for cache
     bool cacheDirty_;            // cacheFlush() will write block if true
     uint32_t cacheMirrorBlock_;  // block number for mirror FAT
+    #if ENABLED(SD_FAT_CACHE)
+      cache_t fatCache_;             // 512 byte read cache for FAT blocks
+      uint32_t fatCacheBlockNumber_; // Logical number of block in the FAT cache
+    #endif
   #else
     static cache_t cacheBuffer_;        // 512 byte cache for device blocks
     static uint32_t cacheBlockNumber_;  // Logical number of block in the cache
     static DiskIODriver *sdCard_;       // DiskIODriver object for cache
     static bool cacheDirty_;            // cacheFlush() will write block if true
     static uint32_t cacheMirrorBlock_;  // block number for mirror FAT
+    #if ENABLED(SD_FAT_CACHE)
+      static cache_t fatCache_;             // 512 byte read cache for FAT blocks
+      static uint32_t fatCacheBlockNumber_; // Logical number of block in the FAT cache
+    #endif
   #endif
 
   uint32_t allocSearchStart_;   // start cluster for alloc search
@@ -175,15 +184,18 @@ class SdVolume {
   #if USE_MULTIPLE_CARDS
     bool cacheFlush();
     bool cacheRawBlock(const uint32_t blockNumber, const bool dirty);
+    TERN_(SD_FAT_CACHE, void fatCacheDrop(const uint32_t blockNumber));
   #else
     static bool cacheFlush();
     static bool cacheRawBlock(const uint32_t blockNumber, const bool dirty);
+    TERN_(SD_FAT_CACHE, static void fatCacheDrop(const uint32_t blockNumber));
   #endif
 
   // used by SdBaseFile write to assign cache to SD location
   void cacheSetBlockNumber(uint32_t blockNumber, bool dirty) {
     cacheDirty_ = dirty;
     cacheBlockNumber_  = blockNumber;
+    TERN_(SD_FAT_CACHE, if (dirty) fatCacheDrop(blockNumber));
   }
   void cacheSetDirty() { cacheDirty_ |= CACHE_FOR_WRITE; }
   bool chainSize(uint32_t cluster, uint32_t * const size);
@@ -91,6 +91,13 @@ MediaFile CardReader::root, CardReader::workDir, CardReader::workDirParents[MAX_
 uint8_t CardReader::workDirDepth;
 int16_t CardReader::nrItems = -1;
 
+#if ENABLED(SD_DIR_INDEX)
+  uint16_t CardReader::dirIndex[SD_DIR_INDEX_SIZE];
+  CardReader::dir_name_t CardReader::dirNames[SD_DIR_INDEX_NAMES];
+  int16_t CardReader::dirNamesFirst;
+  uint8_t CardReader::dirNamesCount;
+#endif
+
 #if ENABLED(SDCARD_SORT_ALPHA)
 
   int16_t CardReader::sort_count;
@@ -151,6 +158,13 @@ DiskIODriver* CardReader::driver = (
 MarlinVolume CardReader::volume;
 MediaFile CardReader::myfile;
 
+#if ENABLED(BINARY_STREAM_UPLOAD)
+  CardReader::upload_t CardReader::upload;
+#endif
+#if ENABLED(SD_EXTENT_MAP)
+  sd_extent_t CardReader::extents[SD_EXTENT_MAP_SIZE];
+#endif
+
 #if HAS_MEDIA_SUBCALLS
   uint8_t CardReader::file_subcall_ctr;
   uint32_t CardReader::filespos[SD_PROCEDURE_DEPTH];
@@ -159,6 +173,9 @@ MediaFile CardReader::myfile;
 
 uint32_t CardReader::filesize, CardReader::sdpos;
 
+uint8_t CardReader::readBuf[512] __attribute__((aligned(sizeof(size_t))));
+uint16_t CardReader::readLen, CardReader::readPos;
+
 CardReader::CardReader() {
   #if ENABLED(SDCARD_SORT_ALPHA)
     sort_count = 0;
@@ -245,6 +262,61 @@ int16_t CardReader::countVisibleItems(MediaFile dir) {
   return c;
 }
 
+#if ENABLED(SD_DIR_INDEX)
+
+  //
+  // Count the visible items in the working directory, noting
+  // the directory entry each one's readDir() starts from
+  //
+  int16_t CardReader::indexVisibleItems() {
+    dir_t p;
+    int16_t c = 0;
+    dirNamesCount = 0;
+    workDir.rewind();
+    for (uint32_t pos = 0; workDir.readDir(&p, longFilename) > 0; pos = workDir.curPosition()) {
+      if (!is_visible_entity(p)) continue;
+      if (c < SD_DIR_INDEX_SIZE) dirIndex[c] = pos >> 5;
+      c++;
+    }
+    hal.watchdog_refresh();
+    return c;
+  }
+
+  //
+  // Get file/folder info for an indexed item from the window of names,
+  // first reading the window around it if it isn't there
+  //
+  bool CardReader::selectIndexedItem(const int16_t nr) {
+    const int16_t count = _MIN(get_num_items(), SD_DIR_INDEX_SIZE);
+    if (!WITHIN(nr, 0, count - 1)) return false;
+
+    if (!WITHIN(nr - dirNamesFirst, 0, dirNamesCount - 1)) {
+      dirNamesFirst = _MAX(0, _MIN(nr - (SD_DIR_INDEX_NAMES) / 2, count - (SD_DIR_INDEX_NAMES)));
+      dirNamesCount = 0;
+      dir_t p;
+      workDir.seekSet(uint32_t(dirIndex[dirNamesFirst]) << 5);
+      while (dirNamesCount < SD_DIR_INDEX_NAMES && workDir.readDir(&p, longFilename) > 0) {
+        if (!is_visible_entity(p)) continue;
+        dir_name_t &n = dirNames[dirNamesCount++];
+        createFilename(n.filename, p);
+        strcpy(n.longFilename, longFilename);
+        n.isDir = flag.filenameIsDir;
+        n.isBin = fileIsBinary();
+      }
+      hal.watchdog_refresh();
+      if (nr - dirNamesFirst >= dirNamesCount) return false;
+    }
+
+    const dir_name_t &n = dirNames[nr - dirNamesFirst];
+    strcpy(filename, n.filename);
+    strcpy(longFilename, n.longFilename);
+    flag.filenameIsDir = n.isDir;
+    setBinFlag(n.isBin);
+    return true;
+  }
+
+#endif // SD_DIR_INDEX
+
 //
 // Get file/folder info for an item by index
 //
@@ -545,9 +617,10 @@ void CardReader::manage_media() {
   /**
    * Handle device tasks (e.g., USB Drive insert / remove)
    *  - USB Flash Drive needs to run even when not selected.
-   *  - SD Card currently has no background tasks.
+   *  - SDIO read-ahead finishes its transfers here.
    */
   //driver->idle();
+  TERN_(SDIO_READ_AHEAD, media_driver_sdcard.idle());
   #if HAS_USB_FLASH_DRIVE
     //if (!isFlashDriveSelected())
       media_driver_usbFlash.idle();
@@ -836,6 +909,8 @@ void CardReader::openFileRead(const char * const path, const uint8_t subcall_typ
   if (myfile.open(diveDir, fname, O_READ)) {
     filesize = myfile.fileSize();
     sdpos = 0;
+    resetReadBuffer();
+    TERN_(SD_EXTENT_MAP, myfile.mapExtents(extents, COUNT(extents)));
 
     { // Don't remove this block, as the PORT_REDIRECT is a RAII
       PORT_REDIRECT(SerialMask::All);
@@ -875,6 +950,7 @@ void CardReader::openFileWrite(const char * const path) {
   #if DISABLED(SDCARD_READONLY)
     if (myfile.open(diveDir, fname, O_CREAT | O_APPEND | O_WRITE | O_TRUNC)) {
       flag.saving = true;
+      nrItems = -1;
       selectFileByName(fname);
       TERN_(EMERGENCY_PARSER, emergency_parser.disable());
       echo_write_to_file(fname);
@@ -930,6 +1006,8 @@ void CardReader::removeFile(const char * const name) {
     if (myfile.remove(itsDirPtr, fname)) {
       SERIAL_ECHOLNPGM("File deleted:", fname);
       sdpos = 0;
+      resetReadBuffer();
+      nrItems = -1;
       TERN_(SDCARD_SORT_ALPHA, presort());
     }
     else
@@ -1092,14 +1170,151 @@ void CardReader::write_command(char * const buf) {
 
 #endif // ONE_CLICK_PRINT
 
+//
+// Refill the read-ahead buffer from the current file position
+//
+bool CardReader::fillReadBuffer() {
+  resetReadBuffer();
+  // Stop at the block boundary so the following fills are aligned
+  const int16_t n = myfile.read(readBuf, sizeof(readBuf) - (sdpos & (sizeof(readBuf) - 1)));
+  if (n <= 0) return false;
+  readLen = n;
+  return true;
+}
+
+//
+// Read a run of bytes, taking any read-ahead first
+//
+int16_t CardReader::read(void *buf, uint16_t nbyte) {
+  if (!myfile.isOpen()) return -1;
+  uint8_t *dst = (uint8_t*)buf;
+  const uint16_t n = _MIN(nbyte, uint16_t(readLen - readPos));
+  memcpy(dst, readBuf + readPos, n);
+  readPos += n;
+  sdpos += n;
+  if (n == nbyte) return n;
+  const int16_t r = myfile.read(dst + n, nbyte - n);
+  if (r < 0) return n ? n : -1;
+  sdpos += r;
+  return n + r;
+}
+
+//
+// Consume the bytes up to and including the next end-of-line, or up to the
+// end of the buffered block if it has none. Returns nullptr on error or EOF.
+//
+const char* CardReader::getSpan(uint16_t &len) {
+  if (readPos >= readLen && !fillReadBuffer()) return nullptr;
+  const char * const start = (const char*)readBuf + readPos;
+  const uint16_t avail = readLen - readPos;
+  const char *eol = (const char*)memchr(start, '\n', avail);
+  const char * const cr = (const char*)memchr(start, '\r', eol ? eol - start : avail);
+  if (cr) eol = cr;
+  len = eol ? eol - start + 1 : avail;
+  readPos += len;
+  sdpos += len;
+  return start;
+}
+
+//
+// Read the next line without its end-of-line, dropping whatever doesn't fit.
+// A CR LF pair counts as one end-of-line when both are in the buffer.
+// Returns the line length, or -1 at the end of the file.
+//
+int16_t CardReader::readLine(char * const line, const uint16_t size) {
+  uint16_t i = 0, len;
+  bool got = false;
+  while (const char * const span = getSpan(len)) {
+    got = true;
+    const char c = span[len - 1];
+    const bool eol = ISEOL(c);
+    const uint16_t n = _MIN(uint16_t(len - eol), uint16_t(size - 1 - i));
+    memcpy(line + i, span, n);
+    i += n;
+    if (eol) {
+      if (c == '\r' && readPos < readLen && readBuf[readPos] == '\n') { readPos++; sdpos++; }
+      break;
+    }
+  }
+  line[i] = '\0';
+  return got ? i : -1;
+}
+
+#if ENABLED(BINARY_STREAM_UPLOAD)
+
+  /**
+   * Reserve a contiguous run of clusters for the file just opened for write
+   * and stream its blocks into the run with one multi-block write, instead of
+   * writing one block at a time and walking the FAT at each cluster. Return
+   * false to leave write() as it was, if no run of that size is free.
+   *
+   * No other file may be opened until uploadFinish().
+   */
+  bool CardReader::uploadStart(const uint32_t size) {
+    uint32_t block;
+    if (upload.active || !myfile.preAllocate(size, &block)) return false;
+    upload.left = (size + 511) >> 9;
+    upload.bytes = 0;
+    upload.active = driver->writeStart(block, upload.left);
+    if (!upload.active) myfile.truncate(0);
+    return upload.active;
+  }
+
+  //
+  // Stream whole blocks into the run. A short block must be the last one.
+  //
+  int16_t CardReader::uploadWrite(const void * const buf, const uint16_t nbyte) {
+    if (upload.bytes & 0x1FF) return -1;
+    const uint8_t *src = (const uint8_t*)buf;
+    for (uint16_t n = nbyte; n;) {
+      if (!upload.left) return -1;
+      const uint16_t len = _MIN(n, 512U);
+      if (len < 512) {
+        // Pad the end of the file in the read buffer, idle while writing
+        memcpy(readBuf, src, len);
+        memset(readBuf + len, 0, 512 - len);
+        src = readBuf;
+      }
+      if (!driver->writeData(src)) return -1;
+      upload.left--;
+      upload.bytes += len;
+      src += len;
+      n -= len;
+    }
+    return nbyte;
+  }
+
+  //
+  // End the multi-block write and give back the part of the run not written
+  //
+  bool CardReader::uploadFinish() {
+    if (!upload.active) return true;
+    upload.active = false;
+    return driver->writeStop() && myfile.truncate(upload.bytes);
+  }
+
+  //
+  // Whether a write would go out without waiting on the card
+  //
+  bool CardReader::uploadReady() {
+    #if NEED_SD2CARD_SDIO && ENABLED(SDIO_READ_AHEAD)
+      if (upload.active && driver == &media_driver_sdcard) return media_driver_sdcard.writeReady();
+    #endif
+    return true;
+  }
+
+#endif // BINARY_STREAM_UPLOAD
+
 //
 // Close the working file.
 //
 void CardReader::closefile(const bool store_location/*=false*/) {
+  TERN_(BINARY_STREAM_UPLOAD, uploadFinish());
   myfile.sync();
   myfile.close();
   flag.saving = flag.logging = false;
   sdpos = 0;
+  resetReadBuffer();
 
   TERN_(EMERGENCY_PARSER, emergency_parser.enable());
 
@@ -1122,6 +1337,9 @@ void CardReader::selectFileByIndex(const int16_t nr) {
       return;
     }
   #endif
+  #if ENABLED(SD_DIR_INDEX)
+    if (selectIndexedItem(nr)) return;
+  #endif
   workDir.rewind();
   selectByIndex(workDir, nr);
   hal.watchdog_refresh(); // Prevent watchdog reset in long listings
@@ -1625,7 +1843,7 @@ void CardReader::cdroot() {
 //
 int16_t CardReader::get_num_items() {
   if (!isMounted()) return 0;
-  if (nrItems < 0) nrItems = countVisibleItems(workDir);
+  if (nrItems < 0) nrItems = TERN(SD_DIR_INDEX, indexVisibleItems(), countVisibleItems(workDir));
   return nrItems;
 }
 
@@ -1686,6 +1904,33 @@ void CardReader::fileHasFinished() {
     }
   }
 
+  #if ENABLED(POWER_LOSS_JOURNAL)
+
+    /**
+     * Get the first block of the job recovery journal, a contiguous file of 'size' bytes.
+     * With 'create' replace a missing or unsuitable file and set 'created'.
+     * Return 0 if there's no journal.
+     */
+    uint32_t CardReader::jobRecoveryJournal(const uint32_t size, const bool create, bool * const created) {
+      *created = false;
+      if (!isMounted() || recovery.file.isOpen()) return 0;
+      uint32_t bgn = 0, end;
+      if (recovery.file.open(&root, recovery.filename, O_READ)) {
+        if (recovery.file.fileSize() != size || !recovery.file.contiguousRange(&bgn, &end)) bgn = 0;
+        recovery.file.close();
+        if (bgn || !create) return bgn;
+        if (!MediaFile::remove(&root, recovery.filename)) return 0;
+      }
+      if (create && recovery.file.createContiguous(&root, recovery.filename, size)) {
+        if (!recovery.file.contiguousRange(&bgn, &end)) bgn = 0;
+        recovery.file.close();
+        *created = bgn != 0;
+      }
+      return bgn;
+    }
+
+  #endif
+
 #endif // POWER_LOSS_RECOVERY
 
 #endif // HAS_MEDIA
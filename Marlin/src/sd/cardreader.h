@@ -310,6 +310,9 @@ public:
     static bool jobRecoverFileExists();
     static void openJobRecoveryFile(const bool read);
     static void removeJobRecoveryFile();
+    #if ENABLED(POWER_LOSS_JOURNAL)
+      static uint32_t jobRecoveryJournal(const uint32_t size, const bool create, bool * const created);
+    #endif
   #endif
 
   // Binary flag for the current file
@@ -326,11 +329,33 @@ public:
   static bool isFileOpen()       { return isMounted() && myfile.isOpen(); }
   static bool eof()              { return getIndex() >= getFileSize(); }
 
+  // Directory entry of the open file, used to recognize it again later
+  static uint32_t getFileCluster()             { return myfile.firstCluster(); }
+  static bool getFileDirEntry(dir_t * const d) { return myfile.dirEntry(d); }
+
   // File data operations
-  static int16_t get()                            { int16_t out = (int16_t)myfile.read(); sdpos = myfile.curPosition(); return out; }
-  static int16_t read(void *buf, uint16_t nbyte)  { return myfile.isOpen() ? myfile.read(buf, nbyte) : -1; }
-  static int16_t write(void *buf, uint16_t nbyte) { return myfile.isOpen() ? myfile.write(buf, nbyte) : -1; }
-  static void setIndex(const uint32_t index)      { myfile.seekSet((sdpos = index)); }
+  static int16_t get() {
+    if (readPos >= readLen && !fillReadBuffer()) return -1;
+    sdpos++;
+    return readBuf[readPos++];
+  }
+  static int16_t read(void *buf, uint16_t nbyte);
+  static int16_t write(void *buf, uint16_t nbyte) {
+    TERN_(BINARY_STREAM_UPLOAD, if (upload.active) return uploadWrite(buf, nbyte));
+    return myfile.isOpen() ? myfile.write(buf, nbyte) : -1;
+  }
+  static void setIndex(const uint32_t index)      { resetReadBuffer(); myfile.seekSet((sdpos = index)); }
+
+  #if ENABLED(BINARY_STREAM_UPLOAD)
+    // Write a file of known size into a contiguous run with a multi-block write
+    static bool uploadStart(const uint32_t size);
+    static bool uploadFinish();
+    static bool uploadReady();
+  #endif
+
+  // Line-oriented reading from the read-ahead buffer
+  static const char* getSpan(uint16_t &len);
+  static int16_t readLine(char * const line, const uint16_t size);
 
   #if ENABLED(AUTO_REPORT_SD_STATUS)
     //
@@ -348,8 +373,30 @@ private:
   static MarlinVolume volume;
 
   static MediaFile myfile;
+  #if ENABLED(BINARY_STREAM_UPLOAD)
+    static struct upload_t {
+      bool active;            // Writes stream into the run reserved by uploadStart()
+      uint32_t left,          // Blocks of the run not yet written
+               bytes;         // File bytes written so far
+    } upload;
+    static int16_t uploadWrite(const void * const buf, const uint16_t nbyte);
+  #endif
+  #if ENABLED(SD_EXTENT_MAP)
+    static sd_extent_t extents[SD_EXTENT_MAP_SIZE]; // Cluster runs of myfile, for reads and seeks without the FAT
+  #endif
   static uint32_t filesize, // Total size of the current file, in bytes
-                  sdpos;    // Index most recently read (one behind file.getPos)
+                  sdpos;    // Index of the next byte to be read (myfile is ahead by the buffered bytes)
+
+  //
+  // Read-ahead buffer. Refills read up to the next block boundary, so after
+  // the first one every fill is a whole, aligned block read straight from the
+  // card instead of one trip through the volume cache per byte.
+  // STM32 (and others?) require a word-aligned buffer for SD card transfers via DMA
+  //
+  static uint8_t readBuf[512] __attribute__((aligned(sizeof(size_t))));
+  static uint16_t readLen, readPos;
+  static bool fillReadBuffer();
+  static void resetReadBuffer() { readLen = readPos = 0; }
 
   //
   // Working directory and parents
@@ -358,6 +405,24 @@ private:
   static uint8_t workDirDepth;
   static int16_t nrItems; // Cache the total count
 
+  //
+  // Directory index, rebuilt along with nrItems. Holds where each visible item
+  // starts and a window of names, so a file browser can draw and scroll without
+  // rescanning the directory for every row.
+  //
+  #if ENABLED(SD_DIR_INDEX)
+    typedef struct {
+      char filename[FILENAME_LENGTH], longFilename[LONG_FILENAME_LENGTH];
+      bool isDir, isBin;
+    } dir_name_t;
+    static uint16_t dirIndex[SD_DIR_INDEX_SIZE];          // Directory entry (position / 32) to read each item from
+    static dir_name_t dirNames[SD_DIR_INDEX_NAMES];       // Names of the items from dirNamesFirst on
+    static int16_t dirNamesFirst;
+    static uint8_t dirNamesCount;
+    static int16_t indexVisibleItems();
+    static bool selectIndexedItem(const int16_t nr);
+  #endif
+
   //
   // Alphabetical file and folder sorting
   //
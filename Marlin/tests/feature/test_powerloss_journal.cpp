@@ -0,0 +1,198 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2024 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * Power-loss recovery journal
+ *
+ * Runs the journal on a small RAM disk that counts block writes, and checks
+ * that loading finds the newest valid entry after wrap-around, torn writes,
+ * a new full state and a reopened session.
+ */
+
+#include "../test/unit_tests.h"
+
+#if ENABLED(POWER_LOSS_JOURNAL)
+
+#include <src/feature/powerloss_journal.h>
+
+struct TestState { uint32_t id; char name[40]; };
+struct TestRecord { uint32_t sdpos; float z; };
+
+static constexpr uint16_t journal_blocks = 6, first_block = 100;
+typedef PowerLossJournal<TestState, TestRecord, journal_blocks> TestJournal;
+
+class RamDisk : public DiskIODriver {
+public:
+  uint8_t blocks[first_block + journal_blocks][512];
+  uint32_t block_writes, streamed;
+
+  bool init(const uint8_t, const pin_t) override { return true; }
+  bool readCSD(csd_t * const) override { return false; }
+  bool readStart(const uint32_t) override { return false; }
+  bool readData(uint8_t * const) override { return false; }
+  bool readStop() override { return false; }
+
+  uint32_t next;
+  bool writeStart(const uint32_t block, const uint32_t) override { next = block; return true; }
+  bool writeData(const uint8_t * const src) override { streamed++; return writeRaw(next++, src); }
+  bool writeStop() override { return true; }
+
+  bool readBlock(const uint32_t block, uint8_t * const dst) override {
+    if (block >= COUNT(blocks)) return false;
+    memcpy(dst, blocks[block], 512);
+    return true;
+  }
+  bool writeBlock(const uint32_t block, const uint8_t * const src) override {
+    block_writes++;
+    return writeRaw(block, src);
+  }
+
+  uint32_t cardSize() override { return COUNT(blocks); }
+  bool isReady() override { return true; }
+  void idle() override {}
+
+private:
+  bool writeRaw(const uint32_t block, const uint8_t * const src) {
+    if (block >= COUNT(blocks)) return false;
+    memcpy(blocks[block], src, 512);
+    return true;
+  }
+};
+
+static RamDisk disk;
+
+static TestState make_state(const uint32_t id) {
+  TestState s{};
+  s.id = id;
+  snprintf(s.name, sizeof(s.name), "/JOB%u.GCO", unsigned(id));
+  return s;
+}
+
+// A fresh journal over a disk full of old data
+static void fresh(TestJournal &j) {
+  memset(disk.blocks, 0xA5, sizeof(disk.blocks));
+  disk.block_writes = disk.streamed = 0;
+  TEST_ASSERT_TRUE(j.open(&disk, first_block, true));
+}
+
+// Load from a journal opened again, as after a reboot
+static bool reload(TestState &s, TestRecord &r, bool &has_record) {
+  TestJournal j;
+  return j.open(&disk, first_block, false) && j.load(s, r, has_record);
+}
+
+MARLIN_TEST(powerloss_journal, erased_is_empty) {
+  TestJournal j;
+  fresh(j);
+  TEST_ASSERT_EQUAL_UINT32(journal_blocks, disk.streamed);
+  TEST_ASSERT_EQUAL_UINT32(0, disk.block_writes);
+
+  TestState s; TestRecord r; bool has_record;
+  TEST_ASSERT_FALSE(reload(s, r, has_record));
+  TEST_ASSERT_FALSE(has_record);
+}
+
+MARLIN_TEST(powerloss_journal, one_block_per_save) {
+  TestJournal j;
+  fresh(j);
+  TEST_ASSERT_TRUE(j.writeState(make_state(1)));
+  for (uint32_t i = 1; i <= 100; i++) TEST_ASSERT_TRUE(j.writeRecord({ i * 1000, i * 0.2f }));
+  TEST_ASSERT_EQUAL_UINT32(101, disk.block_writes);
+
+  // The ring has wrapped many times and the newest record still wins
+  TestState s; TestRecord r; bool has_record;
+  TEST_ASSERT_TRUE(reload(s, r, has_record));
+  TEST_ASSERT_EQUAL_UINT32(1, s.id);
+  TEST_ASSERT_EQUAL_STRING("/JOB1.GCO", s.name);
+  TEST_ASSERT_TRUE(has_record);
+  TEST_ASSERT_EQUAL_UINT32(100000, r.sdpos);
+  TEST_ASSERT_EQUAL_FLOAT(20.0f, r.z);
+}
+
+MARLIN_TEST(powerloss_journal, torn_record) {
+  TestJournal j;
+  fresh(j);
+  TEST_ASSERT_TRUE(j.writeState(make_state(1)));
+  // 16-byte entries, so records 1-32 fill the first ring block and 33-40 go in the second
+  for (uint32_t i = 1; i <= 40; i++) TEST_ASSERT_TRUE(j.writeRecord({ i, 0 }));
+
+  TestState s; TestRecord r; bool has_record;
+  uint8_t * const blk = disk.blocks[first_block + 3];
+
+  // A damaged entry gives way to the one before it
+  blk[7 * 16 + 4] ^= 0xFF;
+  TEST_ASSERT_TRUE(reload(s, r, has_record));
+  TEST_ASSERT_TRUE(has_record);
+  TEST_ASSERT_EQUAL_UINT32(39, r.sdpos);
+
+  // A torn write spoils the whole block it rewrites, records 33-39 included,
+  // so loading falls back to the last record of the previous block
+  memset(blk, 0xFF, 512);
+  TEST_ASSERT_TRUE(reload(s, r, has_record));
+  TEST_ASSERT_TRUE(has_record);
+  TEST_ASSERT_EQUAL_UINT32(32, r.sdpos);
+}
+
+MARLIN_TEST(powerloss_journal, state_supersedes_records) {
+  TestJournal j;
+  fresh(j);
+  TEST_ASSERT_TRUE(j.writeState(make_state(1)));
+  for (uint32_t i = 1; i <= 5; i++) TEST_ASSERT_TRUE(j.writeRecord({ i, 0 }));
+  TEST_ASSERT_TRUE(j.writeState(make_state(2)));
+
+  TestState s; TestRecord r; bool has_record;
+  TEST_ASSERT_TRUE(reload(s, r, has_record));
+  TEST_ASSERT_EQUAL_UINT32(2, s.id);
+  TEST_ASSERT_FALSE(has_record);
+
+  // A torn state falls back to the one before, with the records that followed it
+  disk.blocks[first_block + 1][20] ^= 0xFF;
+  TEST_ASSERT_TRUE(reload(s, r, has_record));
+  TEST_ASSERT_EQUAL_UINT32(1, s.id);
+  TEST_ASSERT_TRUE(has_record);
+  TEST_ASSERT_EQUAL_UINT32(5, r.sdpos);
+}
+
+MARLIN_TEST(powerloss_journal, session_continues) {
+  {
+    TestJournal j;
+    fresh(j);
+    TEST_ASSERT_TRUE(j.writeState(make_state(1)));
+    for (uint32_t i = 1; i <= 9; i++) TEST_ASSERT_TRUE(j.writeRecord({ i, 0 }));
+  }
+
+  // After a reboot the resumed job goes on from the newest entry
+  TestJournal j;
+  TEST_ASSERT_TRUE(j.open(&disk, first_block, false));
+  TestState s; TestRecord r; bool has_record;
+  TEST_ASSERT_TRUE(j.load(s, r, has_record));
+  TEST_ASSERT_EQUAL_UINT32(9, r.sdpos);
+
+  TEST_ASSERT_TRUE(j.writeState(make_state(3)));
+  TEST_ASSERT_TRUE(j.writeRecord({ 42, 1.0f }));
+  TEST_ASSERT_TRUE(reload(s, r, has_record));
+  TEST_ASSERT_EQUAL_UINT32(3, s.id);
+  TEST_ASSERT_TRUE(has_record);
+  TEST_ASSERT_EQUAL_UINT32(42, r.sdpos);
+}
+
+#endif // POWER_LOSS_JOURNAL
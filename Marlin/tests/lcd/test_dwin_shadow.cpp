@@ -0,0 +1,75 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2024 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "../test/unit_tests.h"
+#include <src/lcd/e3v2/creality/dwin_shadow.h>
+
+MARLIN_TEST(dwin_shadow, unchanged_values_are_skipped) {
+  DWINShadow shadow;
+  TEST_ASSERT_TRUE(shadow.update(0, 215, 25, 100, 64, 121, 0, 0));     // First draw
+  TEST_ASSERT_FALSE(shadow.update(0, 215, 25, 100, 64, 121, 0, 1000)); // Same value
+  TEST_ASSERT_TRUE(shadow.update(0, 216, 25, 100, 64, 121, 0, 2000));  // Changed
+  TEST_ASSERT_EQUAL(2, shadow.drawn);
+  TEST_ASSERT_EQUAL(1, shadow.skipped);
+}
+
+MARLIN_TEST(dwin_shadow, fills_force_a_redraw) {
+  DWINShadow shadow;
+  shadow.update(0, 215, 25, 100, 64, 121, 0, 0);
+  shadow.update(1, 60, 25, 130, 64, 151, 0, 0);
+
+  shadow.cover(0, 0, 239, 99);                                         // Above both
+  TEST_ASSERT_TRUE(shadow.is_valid(0));
+  shadow.cover(60, 110, 80, 112);                                      // Clips field 0 only
+  TEST_ASSERT_FALSE(shadow.is_valid(0));
+  TEST_ASSERT_TRUE(shadow.is_valid(1));
+  TEST_ASSERT_TRUE(shadow.update(0, 215, 25, 100, 64, 121, 0, 0));
+
+  shadow.invalidate();
+  TEST_ASSERT_TRUE(shadow.update(1, 60, 25, 130, 64, 151, 0, 0));
+}
+
+MARLIN_TEST(dwin_shadow, budget_defers_changes) {
+  DWINShadow shadow(100);
+  uint32_t tx = 0;
+  shadow.update(0, 1, 0, 0, 9, 9, tx, 0);
+  shadow.update(1, 1, 20, 0, 29, 9, tx, 0);
+
+  TEST_ASSERT_TRUE(shadow.update(0, 2, 0, 0, 9, 9, tx, 10));
+  tx += 150;                                                           // Over budget for this second
+  TEST_ASSERT_FALSE(shadow.update(1, 2, 20, 0, 29, 9, tx, 500));
+  TEST_ASSERT_EQUAL(1, shadow.deferred);
+  TEST_ASSERT_EQUAL(1, shadow.value(1));                               // Still pending
+
+  shadow.invalidate(1);                                                // Painted over: draw regardless
+  TEST_ASSERT_TRUE(shadow.update(1, 2, 20, 0, 29, 9, tx, 600));
+
+  TEST_ASSERT_TRUE(shadow.update(0, 3, 0, 0, 9, 9, tx, 1100));         // Next second
+}
+
+MARLIN_TEST(dwin_shadow, changed_digit_runs) {
+  TEST_ASSERT_EQUAL(1, DWINShadow::changed_digits(41, 42, 2));
+  TEST_ASSERT_EQUAL(2, DWINShadow::changed_digits(49, 50, 2));
+  TEST_ASSERT_EQUAL(2, DWINShadow::changed_digits(59, 0, 2));
+  TEST_ASSERT_EQUAL(0, DWINShadow::changed_digits(7, 7, 2));
+  TEST_ASSERT_EQUAL(2, DWINShadow::changed_digits(205, 215, 3));
+}
@@ -0,0 +1,172 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2024 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "../test/unit_tests.h"
+#include <src/lcd/e3v2/creality/dwin_thumb.h>
+
+// Stand-in for LCD_SERIAL that records every byte written
+struct MockLCDSerial {
+  uint8_t buf[512];
+  uint32_t count = 0;
+  size_t write(const uint8_t c) { if (count < sizeof(buf)) buf[count] = c; count++; return 1; }
+};
+
+typedef DWINThumbBlit<MockLCDSerial> Blit;
+
+// Time to push n bytes through the 8N1 link at the DWIN baud rate
+static uint32_t wire_us(const uint32_t n) { return uint32_t(uint64_t(n) * 10 * 1000000UL / 115200UL); }
+
+// Old path: a set color + fill rectangle pair and a 4ms delay for every pixel
+static uint32_t legacy_frame_us(const uint16_t w, const uint16_t h) {
+  return uint32_t(w) * h * (wire_us(DWIN_SET_COLOR_BYTES + DWIN_FILL_RECT_BYTES) + 4000UL);
+}
+
+// A plausible preview: flat background with a shaded object in the middle
+static uint16_t test_pixel(const uint8_t x, const uint8_t y) {
+  const bool inside = x >= 24 && x < 72 && y >= 16 && y < 80;
+  return inside ? uint16_t(0x0400 + ((x / 3) << 5) + (y / 4)) : 0x2104;
+}
+
+MARLIN_TEST(dwin_thumb, flat_row_is_one_run) {
+  MockLCDSerial port;
+  uint16_t row[THUMB_MAX_W];
+  for (uint8_t x = 0; x < THUMB_MAX_W; x++) row[x] = 0xF800;
+  const uint16_t bytes = Blit::row(port, 12, 25, row, THUMB_MAX_W);
+  TEST_ASSERT_EQUAL(DWIN_SET_COLOR_BYTES + DWIN_FILL_RECT_BYTES, bytes);
+  TEST_ASSERT_EQUAL(bytes, port.count);
+}
+
+MARLIN_TEST(dwin_thumb, row_frames_are_exact) {
+  MockLCDSerial port;
+  const uint16_t row[3] = { 0x1234, 0x1234, 0xABCD };
+  Blit::row(port, 12, 25, row, 3);
+  const uint8_t expected[] = {
+    0xAA, 0x40, 0x12, 0x34, 0xFF, 0xFF, 0xCC, 0x33, 0xC3, 0x3C,
+    0xAA, 0x5B, 0x00, 0x0C, 0x00, 0x19, 0x00, 0x0D, 0x00, 0x19, 0xCC, 0x33, 0xC3, 0x3C,
+    0xAA, 0x40, 0xAB, 0xCD, 0xFF, 0xFF, 0xCC, 0x33, 0xC3, 0x3C,
+    0xAA, 0x5B, 0x00, 0x0E, 0x00, 0x19, 0x00, 0x0E, 0x00, 0x19, 0xCC, 0x33, 0xC3, 0x3C
+  };
+  TEST_ASSERT_EQUAL(sizeof(expected), port.count);
+  TEST_ASSERT_EQUAL_MEMORY(expected, port.buf, sizeof(expected));
+}
+
+MARLIN_TEST(dwin_thumb, frame_time_budget) {
+  uint32_t bytes = 0;
+  for (uint8_t y = 0; y < THUMB_MAX_H; y++) {
+    MockLCDSerial port;
+    uint16_t row[THUMB_MAX_W];
+    for (uint8_t x = 0; x < THUMB_MAX_W; x++) row[x] = test_pixel(x, y);
+    Blit::row(port, 12, 25 + y, row, THUMB_MAX_W);
+    bytes += port.count;
+  }
+  // Per-pixel framing would send 24 bytes for each of the 9216 pixels
+  TEST_ASSERT_LESS_THAN(uint32_t(THUMB_MAX_W) * THUMB_MAX_H * (DWIN_SET_COLOR_BYTES + DWIN_FILL_RECT_BYTES) / 2, bytes);
+
+  // Whole frame on the wire, including one 8 byte handshake + 8 byte reply per row
+  const uint32_t frame_us = wire_us(bytes + THUMB_MAX_H * 16UL);
+  TEST_ASSERT_LESS_THAN(legacy_frame_us(THUMB_MAX_W, THUMB_MAX_H) / 10, frame_us);
+  TEST_ASSERT_LESS_THAN(3000000UL, frame_us);
+}
+
+//
+// E3V3SE_THUMB_BIN
+//
+
+// Row 40 of test_pixel() as written by SlicerScripts/orca_parser.py.
+// The same text is checked against the encoder by its --test doctests.
+static const char encoder_row_40[] = "lyEEggUKggUqggVKggVqggWKggWqggXKggXqggYKggYqggZKggZqggaKggaqggbKggbqlyEE3To=";
+
+// Reference packer with the same packet rules as pack_row_565() in orca_parser.py
+static uint16_t pack_row(const uint16_t *px, const uint8_t w, uint8_t *out) {
+  uint16_t n = 0;
+  for (uint8_t i = 0; i < w;) {
+    uint8_t run = 1;
+    while (i + run < w && run < 128 && px[i + run] == px[i]) run++;
+    if (run >= 2) {
+      out[n++] = 0x80 | (run - 1);
+      out[n++] = px[i] >> 8; out[n++] = px[i] & 0xFF;
+      i += run;
+    }
+    else {
+      // Gather literals up to the next run
+      uint8_t lit = 0;
+      while (i + lit < w && lit < 128 && !(i + lit + 1 < w && px[i + lit + 1] == px[i + lit])) lit++;
+      out[n++] = lit - 1;
+      for (uint8_t k = 0; k < lit; k++) { out[n++] = px[i + k] >> 8; out[n++] = px[i + k] & 0xFF; }
+      i += lit;
+    }
+  }
+  uint16_t crc = 0;
+  crc16(&crc, out, n);
+  out[n++] = crc >> 8; out[n++] = crc & 0xFF;
+  return n;
+}
+
+static void b64_encode(const uint8_t *in, const uint16_t n, char *out) {
+  static const char digits[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  for (uint16_t i = 0; i < n; i += 3) {
+    const uint32_t v = (uint32_t(in[i]) << 16) | (i + 1 < n ? in[i + 1] << 8 : 0) | (i + 2 < n ? in[i + 2] : 0);
+    *out++ = digits[(v >> 18) & 0x3F];
+    *out++ = digits[(v >> 12) & 0x3F];
+    *out++ = i + 1 < n ? digits[(v >> 6) & 0x3F] : '=';
+    *out++ = i + 2 < n ? digits[v & 0x3F] : '=';
+  }
+  *out = '\0';
+}
+
+MARLIN_TEST(dwin_thumb, bin_decodes_encoder_output) {
+  uint16_t row[THUMB_MAX_W];
+  TEST_ASSERT_TRUE(thumb_bin_decode_row(encoder_row_40, row, THUMB_MAX_W));
+  for (uint8_t x = 0; x < THUMB_MAX_W; x++) TEST_ASSERT_EQUAL_HEX16(test_pixel(x, 40), row[x]);
+}
+
+MARLIN_TEST(dwin_thumb, bin_rejects_damaged_rows) {
+  uint16_t row[THUMB_MAX_W];
+  char bad[sizeof(encoder_row_40)];
+  strcpy(bad, encoder_row_40);
+  bad[10] = bad[10] == 'A' ? 'B' : 'A';
+  TEST_ASSERT_FALSE(thumb_bin_decode_row(bad, row, THUMB_MAX_W));       // CRC mismatch
+  TEST_ASSERT_FALSE(thumb_bin_decode_row(encoder_row_40, row, 95));     // Wrong width
+  TEST_ASSERT_FALSE(thumb_bin_decode_row("lyE*", row, THUMB_MAX_W));    // Not base64
+}
+
+MARLIN_TEST(dwin_thumb, bin_round_trip) {
+  uint8_t packed[THUMB_BIN_ROW_BYTES];
+  char text[THUMB_BIN_ROW_BYTES * 4 / 3 + 4];
+  uint16_t src[THUMB_MAX_W], row[THUMB_MAX_W];
+  uint32_t bin_chars = 0;
+
+  // Every row of the sample image, then worst-case noise
+  for (uint8_t y = 0; y <= THUMB_MAX_H; y++) {
+    for (uint8_t x = 0; x < THUMB_MAX_W; x++)
+      src[x] = y < THUMB_MAX_H ? test_pixel(x, y) : uint16_t(x * 40503U + 7);
+    const uint16_t n = pack_row(src, THUMB_MAX_W, packed);
+    TEST_ASSERT_LESS_OR_EQUAL(THUMB_BIN_ROW_BYTES, n);
+    b64_encode(packed, n, text);
+    TEST_ASSERT_TRUE(thumb_bin_decode_row(text, row, THUMB_MAX_W));
+    TEST_ASSERT_EQUAL_MEMORY(src, row, sizeof(src));
+    if (y < THUMB_MAX_H) bin_chars += strlen(text);
+  }
+
+  // RAW16 spends 4 characters per pixel, this image should take under 1
+  TEST_ASSERT_LESS_THAN(uint32_t(THUMB_MAX_W) * THUMB_MAX_H, bin_chars);
+}
@@ -0,0 +1,99 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2024 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "../test/unit_tests.h"
+#include <src/lcd/e3v2/creality/dwin_tx.h>
+
+// Stand-in for LCD_SERIAL with a UART TX buffer of limited room
+struct MockLCDSerial {
+  uint8_t buf[4096];
+  uint32_t count = 0;
+  int room = 0;             // What availableForWrite() reports
+  size_t write(const uint8_t c) { if (count < sizeof(buf)) buf[count] = c; count++; if (room) room--; return 1; }
+  int availableForWrite() { return room; }
+};
+
+typedef DWINTxQueue<MockLCDSerial, 64> TxQueue;
+
+static const uint8_t tail[] = { 0xCC, 0x33, 0xC3, 0x3C };
+
+// Build a recognizable frame: AA, cmd, n payload bytes, tail
+static uint16_t make_frame(uint8_t *out, const uint8_t cmd, const uint8_t n) {
+  uint16_t i = 0;
+  out[i++] = 0xAA; out[i++] = cmd;
+  for (uint8_t k = 0; k < n; k++) out[i++] = cmd + k;
+  for (uint8_t k = 0; k < 4; k++) out[i++] = tail[k];
+  return i;
+}
+
+MARLIN_TEST(dwin_tx, writes_return_without_port) {
+  MockLCDSerial port;
+  TxQueue q(port);
+  uint8_t f[32];
+  const uint16_t n = make_frame(f, 0x40, 4);
+  q.write(f, n);
+  q.write(f, n);
+  TEST_ASSERT_EQUAL(0, port.count);         // Nothing sent until pumped
+  TEST_ASSERT_EQUAL(2 * n, q.used());
+  TEST_ASSERT_EQUAL(2 * n, q.high_water);
+}
+
+MARLIN_TEST(dwin_tx, pump_respects_port_room) {
+  MockLCDSerial port;
+  TxQueue q(port);
+  uint8_t f[32];
+  const uint16_t n = make_frame(f, 0x5B, 8);
+  q.write(f, n);
+  port.room = 5;
+  q.pump();
+  TEST_ASSERT_EQUAL(5, port.count);
+  TEST_ASSERT_EQUAL(n - 5, q.used());
+  port.room = 100;
+  q.pump();
+  TEST_ASSERT_EQUAL(n, port.count);
+  TEST_ASSERT_TRUE(q.empty());
+  TEST_ASSERT_EQUAL_MEMORY(f, port.buf, n);
+}
+
+MARLIN_TEST(dwin_tx, frames_stay_ordered_and_exact) {
+  MockLCDSerial port;
+  TxQueue q(port);
+  uint8_t expected[2048], f[32];
+  uint16_t total = 0;
+
+  // Many frames through a small ring with uneven draining, wrapping many times
+  for (uint8_t k = 0; k < 100; k++) {
+    const uint16_t n = make_frame(f, k, k % 11);
+    q.write(f, n);
+    memcpy(expected + total, f, n);
+    total += n;
+    port.room = k % 7;
+    q.pump();
+  }
+  q.flush();
+
+  TEST_ASSERT_EQUAL(total, port.count);
+  TEST_ASSERT_EQUAL_MEMORY(expected, port.buf, total);
+  TEST_ASSERT_EQUAL(total, q.bytes);
+  TEST_ASSERT_EQUAL(63, q.high_water);      // The ring filled up...
+  TEST_ASSERT_GREATER_THAN(0, q.stalls);    // ...and writers waited for room
+}
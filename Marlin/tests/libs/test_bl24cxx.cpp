@@ -0,0 +1,222 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2024 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "../test/unit_tests.h"
+#include <src/libs/BL24CXX_page.h>
+#include <src/module/printcounter.h>
+
+// A 24C16 on the bus: 2K, 16-byte pages, busy (NACK) for a few polls after each write
+struct Sim24C16 {
+  static uint8_t mem[2048], page[16];
+  static uint16_t ptr;
+  static uint8_t state, block, count, busy;
+  static bool acked, reading;
+  static uint32_t transfers, bytes, polls, cycles;
+
+  enum : uint8_t { IDLE, CONTROL, WORD, DATA };
+
+  static void reset() {
+    memset(mem, 0xFF, sizeof(mem));
+    ptr = state = count = busy = 0;
+    transfers = bytes = polls = cycles = 0;
+  }
+
+  static void start() { transfers++; state = CONTROL; count = 0; }
+
+  static void stop() {
+    if (state == DATA && !reading && count) {   // Commit the page buffer
+      for (uint8_t i = 0; i < count; i++) mem[(ptr & ~0xF) | ((ptr + i) & 0xF)] = page[i];
+      ptr = (ptr & ~0xF) | ((ptr + count) & 0xF);
+      busy = 3;
+      cycles++;
+    }
+    state = IDLE;
+  }
+
+  static void send_byte(const uint8_t b) {
+    bytes++;
+    switch (state) {
+      case CONTROL:
+        acked = (b & 0xF0) == 0xA0 && !busy;
+        if (!acked) { if (busy) { busy--; polls++; } break; }
+        block = (b >> 1) & 0x07;
+        reading = b & 0x01;
+        state = reading ? DATA : WORD;
+        break;
+      case WORD: ptr = (block << 8) | b; state = DATA; acked = true; break;
+      case DATA: if (count < 16) page[count] = b; count++; acked = true; break;
+    }
+  }
+
+  static uint8_t wait_ack() { if (acked) return 0; stop(); return 1; }
+
+  static uint8_t read_byte(const unsigned char) {
+    bytes++;
+    const uint8_t b = mem[ptr];
+    ptr = (ptr + 1) & 0x7FF;
+    return b;
+  }
+};
+
+uint8_t Sim24C16::mem[2048], Sim24C16::page[16];
+uint16_t Sim24C16::ptr;
+uint8_t Sim24C16::state, Sim24C16::block, Sim24C16::count, Sim24C16::busy;
+bool Sim24C16::acked, Sim24C16::reading;
+uint32_t Sim24C16::transfers, Sim24C16::bytes, Sim24C16::polls, Sim24C16::cycles;
+
+typedef BL24CXXPage<Sim24C16, 2047> SimPages;
+
+MARLIN_TEST(bl24cxx, page_write_and_sequential_read) {
+  Sim24C16::reset();
+  const uint8_t data[16] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 };
+  TEST_ASSERT_TRUE(SimPages::writePage(0x310, data, 16));
+  TEST_ASSERT_EQUAL(1, Sim24C16::cycles);
+  TEST_ASSERT_EQUAL(3, Sim24C16::polls);                    // ACK polling instead of a fixed delay
+
+  uint8_t back[16];
+  TEST_ASSERT_TRUE(SimPages::read(0x310, back, 16));
+  TEST_ASSERT_EQUAL_MEMORY(data, back, 16);
+  TEST_ASSERT_EQUAL_MEMORY(data, &Sim24C16::mem[0x310], 16); // Upper block selected by the control byte
+}
+
+MARLIN_TEST(bl24cxx, shadow_writes_only_changed_pages) {
+  Sim24C16::reset();
+  EEPROMShadow<SimPages, 2048> shadow;
+  TEST_ASSERT_TRUE(shadow.load());
+  TEST_ASSERT_EQUAL(2, Sim24C16::transfers);                // Whole chip in one sequential read
+
+  // Same values as the chip holds: nothing to send
+  shadow.write(100, 0xFF);
+  TEST_ASSERT_FALSE(shadow.pending());
+
+  // A 40-byte record spanning pages 6..8 plus one byte high up
+  Sim24C16::transfers = Sim24C16::bytes = 0;
+  for (uint16_t i = 0; i < 40; i++) shadow.write(100 + i, uint8_t(i));
+  shadow.write(2000, 0x42);
+  TEST_ASSERT_FALSE(shadow.flush());
+  TEST_ASSERT_EQUAL(4, shadow.pages_written);
+  TEST_ASSERT_EQUAL(4, Sim24C16::cycles);
+  for (uint16_t i = 0; i < 40; i++) TEST_ASSERT_EQUAL(i, Sim24C16::mem[100 + i]);
+  TEST_ASSERT_EQUAL(0x42, Sim24C16::mem[2000]);
+
+  // Per page: write (2 + 16 bytes), 3 busy polls + 1 ready poll, verify read (2 + 1 + 16 bytes)
+  TEST_ASSERT_EQUAL(4 * (1 + 4 + 2), Sim24C16::transfers);
+  TEST_ASSERT_EQUAL(4 * (18 + 4 + 19), Sim24C16::bytes);
+
+  // A second save of the same settings touches nothing
+  Sim24C16::transfers = 0;
+  for (uint16_t i = 0; i < 40; i++) shadow.write(100 + i, uint8_t(i));
+  TEST_ASSERT_FALSE(shadow.pending());
+  TEST_ASSERT_FALSE(shadow.flush());
+  TEST_ASSERT_EQUAL(0, Sim24C16::transfers);
+}
+
+MARLIN_TEST(bl24cxx, verify_failure_keeps_page_dirty) {
+  Sim24C16::reset();
+  EEPROMShadow<SimPages, 2048> shadow;
+  shadow.load();
+  shadow.write(5, 0x12);
+  Sim24C16::busy = 250;                                     // Chip never finishes: poll times out
+  TEST_ASSERT_TRUE(shadow.flush());
+  TEST_ASSERT_EQUAL(1, shadow.verify_errors);
+  TEST_ASSERT_TRUE(shadow.pending());
+
+  Sim24C16::busy = 0;
+  TEST_ASSERT_FALSE(shadow.flush());                        // Retried on the next save
+  TEST_ASSERT_EQUAL(0x12, Sim24C16::mem[5]);
+}
+
+MARLIN_TEST(bl24cxx, background_flush_one_operation_per_step) {
+  Sim24C16::reset();
+  EEPROMShadow<SimPages, 2048> shadow;
+  shadow.load();
+  shadow.write(0x430, 1);                                   // Written second
+  shadow.write(0x020, 2);                                   // Lowest page goes first
+
+  Sim24C16::transfers = 0;
+  TEST_ASSERT_EQUAL(shadow.FLUSH_BUSY, shadow.step());      // Send page 0x020
+  TEST_ASSERT_EQUAL(1, Sim24C16::transfers);
+  TEST_ASSERT_EQUAL(2, Sim24C16::mem[0x020]);
+  TEST_ASSERT_EQUAL(0xFF, Sim24C16::mem[0x430]);
+
+  uint8_t steps = 1;
+  while (shadow.step() == shadow.FLUSH_BUSY) steps++;
+  TEST_ASSERT_EQUAL(1, Sim24C16::mem[0x430]);
+  TEST_ASSERT_FALSE(shadow.pending());
+  TEST_ASSERT_EQUAL(2 * (1 + 3 + 1), steps);                // Per page: send, 3 busy polls, ready poll and verify
+}
+
+// Stand in for PrintCounter::saveStats() and loadStats()
+static void put_stats(uint8_t *image, const printStatistics &stats) {
+  image[STATS_EEPROM_ADDRESS] = 0x16;
+  memcpy(&image[STATS_EEPROM_ADDRESS + 1], &stats, sizeof(stats));
+}
+
+static bool get_stats(const uint8_t *image, printStatistics &stats) {
+  memcpy(&stats, &image[STATS_EEPROM_ADDRESS + 1], sizeof(stats));
+  return image[STATS_EEPROM_ADDRESS] == 0x16;
+}
+
+MARLIN_TEST(bl24cxx, slots_keep_print_statistics) {
+  typedef EEPROMSlots<SimPages, 2048> SimSlots;
+  Sim24C16::reset();
+  Sim24C16::mem[0x01] = 0x33;                               // Written directly by the DWIN UI
+
+  printStatistics stats{};
+  stats.totalPrints = 12;
+  stats.finishedPrints = 10;
+  stats.printTime = 123456;
+  stats.longestPrint = 7200;
+
+  // Each commit goes to the other half, print counter and settings alike
+  for (uint8_t commit = 1; commit <= 2; commit++) {
+    SimSlots slots;
+    TEST_ASSERT_TRUE(slots.load());
+    stats.totalPrints++;
+    put_stats(slots.image, stats);
+    slots.image[100] = commit;                              // First settings byte (EEPROM_OFFSET)
+    slots.commit();
+    TEST_ASSERT_TRUE(slots.committing());
+    while (slots.step() == SimSlots::Shadow::FLUSH_BUSY) { /* nada */ }
+    TEST_ASSERT_FALSE(slots.committing());
+    TEST_ASSERT_EQUAL(commit & 1, slots.active_slot);
+    TEST_ASSERT_EQUAL(commit, slots.active_seq);
+
+    // After a reboot the new half loads with the statistics intact
+    SimSlots after;
+    TEST_ASSERT_TRUE(after.load());
+    TEST_ASSERT_EQUAL(commit & 1, after.active_slot);
+    printStatistics back;
+    TEST_ASSERT_TRUE(get_stats(after.image, back));
+    TEST_ASSERT_EQUAL_MEMORY(&stats, &back, sizeof(stats));
+    TEST_ASSERT_EQUAL(commit, after.image[100]);
+  }
+
+  // Bytes below the commit record belong to neither half
+  TEST_ASSERT_EQUAL(0x33, Sim24C16::mem[0x01]);
+  TEST_ASSERT_EQUAL(0xFF, Sim24C16::mem[1024 + 0x01]);
+  Sim24C16::mem[0x02] = 0x44;                               // ...so a direct write doesn't spoil the lower half
+  SimSlots slots;
+  TEST_ASSERT_TRUE(slots.load());
+  TEST_ASSERT_EQUAL(0, slots.active_slot);
+  TEST_ASSERT_EQUAL(2, slots.active_seq);
+}
@@ -0,0 +1,97 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2024 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "../test/unit_tests.h"
+#include <src/module/AutoOffsetFilter.h>
+
+#define WINDOW   64     // PI_COUNT * 2
+#define SPS      80
+#define K1_NEW   0.9
+
+/**
+ * A probe touch as the HX711 sees it, baseline removed: noise and slow drift,
+ * a few single-sample glitches, then the load rising once the nozzle touches.
+ */
+static int trace(const int i) {
+  static uint32_t seed;
+  if (i == 0) seed = 12345;
+  seed = seed * 1103515245 + 12345;
+  int v = int((seed >> 16) % 121) - 60 + i / 4;
+  if (i % 37 == 19) v += 3000;                    // Glitch
+  if (i > 150) v += (i - 150) * (i - 150) * 6;    // Contact
+  return v;
+}
+
+// The filtered end of a window, as checkTrigger() used to compute it
+static void window_tail(const double *raw, const int n, double out[3]) {
+  double w[WINDOW] = { 0 };
+  for (int i = 0; i < n; i++) w[i] = raw[i];
+  Filters::tFilter(w, n);
+  Filters::hFilter(w, n, 1, SPS);
+  Filters::lFilter(w, n, K1_NEW);
+  for (int i = 0; i < 3 && i < n; i++) out[i] = w[n - 1 - i];
+}
+
+MARLIN_TEST(autooffset_filter, matches_window_from_first_sample) {
+  StreamFilter f;
+  f.reset(Filters::coefficient(1, SPS), K1_NEW);
+  double raw[WINDOW], ref[3];
+  for (int n = 1; n <= WINDOW; n++) {
+    raw[n - 1] = trace(n - 1);
+    f.push(raw[n - 1]);
+    window_tail(raw, n, ref);
+    for (int i = 0; i < 3 && i < n; i++)
+      TEST_ASSERT_FLOAT_WITHIN(0.05 + fabs(ref[i]) * 1e-5, ref[i], f.tail(i));
+  }
+}
+
+MARLIN_TEST(autooffset_filter, tracks_sliding_window) {
+  StreamFilter f;
+  f.reset(Filters::coefficient(1, SPS), K1_NEW);
+  double raw[300], ref[3];
+  for (int n = 0; n < 300; n++) {
+    raw[n] = trace(n);
+    f.push(raw[n]);
+    if (n + 1 < WINDOW) continue;
+    window_tail(&raw[n + 1 - WINDOW], WINDOW, ref);
+    // Only the start of the high-pass differs, and it has decayed by coff^61
+    for (int i = 0; i < 3; i++) TEST_ASSERT_FLOAT_WITHIN(2 + fabs(ref[i]) * 0.01, ref[i], f.tail(i));
+  }
+}
+
+MARLIN_TEST(autooffset_filter, base_statistics) {
+  // readBase(): tFilter + lFilter over 16 samples, then min/avg/max
+  double w[16];
+  for (int i = 0; i < 16; i++) w[i] = 8000 + trace(i);
+  double ref[16];
+  for (int i = 0; i < 16; i++) ref[i] = w[i];
+  Filters::tFilter(ref, 16);
+  Filters::lFilter(ref, 16, K1_NEW);
+
+  StreamFilter f;
+  f.reset(0, K1_NEW);
+  int out = 0;
+  for (int i = 0; i < 16; i++)
+    if (f.push(w[i])) { TEST_ASSERT_FLOAT_WITHIN(0.01, ref[out], f.committed()); out++; }
+  TEST_ASSERT_EQUAL(13, out);
+  for (int i = 0; i < 3; i++) TEST_ASSERT_FLOAT_WITHIN(0.01, ref[15 - i], f.tail(i));
+}
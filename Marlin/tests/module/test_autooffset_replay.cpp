@@ -0,0 +1,77 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2024 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "../test/unit_tests.h"
+#include <src/module/AutoOffsetFilter.h>
+
+/**
+ * Replays probe traces through the same detection the printer runs.
+ * A trace captured with G212 K D can be pasted in as two arrays (the "AZT,"
+ * lines: pressure, then Z in microns / 1000) and checked the same way.
+ */
+
+#define STEP_MM     0.02f
+#define CONTACT_MM  -1.0f     // Where the nozzle meets the bed
+#define N_SAMPLES   200
+
+// Step descent from 0 at STEP_MM per sample: noise and drift, then the load rising with the bed's spring
+static void make_trace(float *val, float *z, const float counts_per_mm) {
+  uint32_t seed = 4321;
+  for (int i = 0; i < N_SAMPLES; i++) {
+    seed = seed * 1103515245 + 12345;
+    z[i] = -STEP_MM * (i + 1);
+    val[i] = float(int((seed >> 16) % 161) - 80) + i * 0.5f;
+    if (z[i] < CONTACT_MM) val[i] += (CONTACT_MM - z[i]) * counts_per_mm;
+  }
+}
+
+MARLIN_TEST(autooffset_replay, finds_contact) {
+  float val[N_SAMPLES], z[N_SAMPLES];
+  make_trace(val, z, 60000);
+  ProbeDetect pd;
+  const int hit = pd.replay(val, z, N_SAMPLES);
+  TEST_ASSERT_TRUE(hit > 0);
+  TEST_ASSERT_TRUE(z[hit] < CONTACT_MM);          // Not before the contact
+  TEST_ASSERT_TRUE(z[hit] > CONTACT_MM - 0.3f);   // ...and not long after it
+  TEST_ASSERT_FLOAT_WITHIN(0.1f, CONTACT_MM, pd.outVal_mm);
+}
+
+MARLIN_TEST(autooffset_replay, no_trigger_without_contact) {
+  float val[N_SAMPLES], z[N_SAMPLES];
+  make_trace(val, z, 0);
+  ProbeDetect pd;
+  TEST_ASSERT_EQUAL(-1, pd.replay(val, z, N_SAMPLES));
+}
+
+MARLIN_TEST(autooffset_replay, threshold_sweep) {
+  float val[N_SAMPLES], z[N_SAMPLES];
+  make_trace(val, z, 60000);
+  ProbeDetect pd;
+  int last = 0;
+  for (int hold = 500; hold <= 8000; hold += 500) {
+    pd.minHold = hold;
+    const int hit = pd.replay(val, z, N_SAMPLES);
+    TEST_ASSERT_TRUE(hit >= last);                // A higher threshold never triggers earlier
+    TEST_ASSERT_FLOAT_WITHIN(0.15f, CONTACT_MM, pd.outVal_mm);
+    last = hit;
+  }
+}
@@ -0,0 +1,240 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2024 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * Motion pipeline benchmark
+ *
+ * Feeds G-code through GcodeSuite, Planner::buffer_line() and recalculate(),
+ * and runs the stepper's pulse and block phases in place of the timer ISR
+ * whenever the planner is full. Reports blocks/s, reverse and forward pass
+ * cost per planned block, the step events generated and a checksum of the
+ * step stream (step directions and ISR intervals).
+ *
+ * Set MOTION_BENCH_GCODE to the path of a recorded print to run it too.
+ * Only motion commands (G0-G3, G90-G92, M82, M83) are fed to the planner.
+ * The steppers are run out before each G92 so its position jump isn't
+ * counted as steps.
+ */
+
+#include "../test/unit_tests.h"
+
+#if ENABLED(MOTION_BENCHMARK)
+
+#include <src/gcode/gcode.h>
+#include <src/gcode/parser.h>
+#include <src/module/motion.h>
+#include <src/module/planner.h>
+#include <src/module/settings.h>
+#include <src/module/stepper.h>
+#include <src/module/temperature.h>
+#include <src/HAL/LINUX/hardware/Clock.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static struct {
+  uint32_t lines, blocks, events, isr_calls, checksum;
+  uint64_t ticks, start_ns, step_ns;
+  xyze_long_t last;
+} bench;
+
+static void fold(const uint32_t v) {
+  for (uint8_t i = 0; i < 4; i++) bench.checksum = (bench.checksum ^ ((v >> (i * 8)) & 0xFF)) * 16777619UL;
+}
+
+// One main ISR call: the pulse phase, then the block phase
+static void step_isr() {
+  Stepper::pulse_phase_isr();
+  const hal_timer_t interval = Stepper::block_phase_isr();
+  bench.isr_calls++;
+  bench.ticks += interval;
+  fold(interval);
+  LOOP_LOGICAL_AXES(a) {
+    const int32_t pos = Stepper::position(AxisEnum(a)), d = pos - bench.last[a];
+    if (!d) continue;
+    bench.events += ABS(d);
+    fold((a << 24) | (d & 0xFFFFFF));
+    bench.last[a] = pos;
+  }
+}
+
+// Step until the stepper releases a block, as the ISR would while the queue is full
+static void step_block() {
+  const uint64_t t0 = Clock::nanos();
+  const uint8_t tail = planner.block_buffer_tail;
+  while (planner.has_blocks_queued() && planner.block_buffer_tail == tail) step_isr();
+  if (planner.block_buffer_tail != tail) bench.blocks++;
+  bench.step_ns += Clock::nanos() - t0;
+}
+
+static void drain() { while (planner.has_blocks_queued()) step_block(); }
+
+static void sync_last() { LOOP_LOGICAL_AXES(a) bench.last[a] = Stepper::position(AxisEnum(a)); }
+
+static void run_line(const char *line);
+
+// Empty the pipeline, zero the counters and start at the middle of the bed
+static void bench_reset() {
+  static bool ready = false;
+  if (!ready) {
+    HAL_timer_init();                       // Pulse timing reads the step timer count
+    settings.reset();
+    TERN_(PREVENT_COLD_EXTRUSION, thermalManager.allow_cold_extrude = true);
+    planner.bench_drain = step_block;
+    ready = true;
+  }
+  drain();
+  run_line("G90");
+  run_line("M82");
+  run_line("G92 X110 Y110 Z0.3 E0");
+  bench = {};
+  bench.checksum = 2166136261UL;            // FNV-1a
+  bench.start_ns = Clock::nanos();
+  sync_last();
+  planner.bench_reverse_ns = planner.bench_forward_ns = 0;
+  planner.bench_recalcs = 0;
+}
+
+// Parse and run one line if it's a motion command
+static void run_line(const char *line) {
+  char cmd[MAX_CMD_SIZE];
+  uint8_t n = 0;
+  while (*line && *line != ';' && *line != '\n' && *line != '\r' && n < sizeof(cmd) - 1) cmd[n++] = *line++;
+  while (n && cmd[n - 1] == ' ') n--;
+  if (!n) return;
+  cmd[n] = '\0';
+
+  parser.parse(cmd);
+  const bool motion = parser.command_letter == 'G'
+    ? (parser.codenum <= 3 || WITHIN(parser.codenum, 90, 92))
+    : parser.command_letter == 'M' && WITHIN(parser.codenum, 82, 83);
+  if (!motion) return;
+  bench.lines++;
+  const bool set_position = parser.command_letter == 'G' && parser.codenum == 92;
+  if (set_position) drain();
+  gcode.process_parsed_command(true);
+  if (set_position) sync_last();
+}
+
+static void bench_report(const char * const name) {
+  drain();
+  const uint64_t plan_ns = Clock::nanos() - bench.start_ns - bench.step_ns;  // Parsing and planning, without stepping
+  const uint32_t recalcs = _MAX(planner.bench_recalcs, 1U);
+  printf("%s: %u lines, %u blocks, %u step events, %u ISR calls, %.2fs of motion\n",
+    name, bench.lines, bench.blocks, bench.events, bench.isr_calls, bench.ticks / float(STEPPER_TIMER_RATE));
+  printf("%s: reverse_pass %u ns/block, forward pass %u ns/block, planner %.0f blocks/s, step checksum %08X\n",
+    name, uint32_t(planner.bench_reverse_ns / recalcs), uint32_t(planner.bench_forward_ns / recalcs),
+    bench.blocks * 1e9 / _MAX(plan_ns, uint64_t(1)), bench.checksum);
+}
+
+// Every step the planner was given came out of the stepper
+static void assert_in_position() {
+  drain();
+  LOOP_LOGICAL_AXES(a) TEST_ASSERT_FLOAT_WITHIN(0.02f, current_position[a], planner.get_axis_position_mm(AxisEnum(a)));
+}
+
+/**
+ * A slicer's curved walls: rings of 0.25mm segments at 100mm/s,
+ * the small-segment case that keeps the planner full and recalculating.
+ */
+static void small_segments() {
+  char line[64];
+  float e = 0;
+  for (uint8_t r = 20; r <= 60; r += 10) {
+    const uint16_t segs = uint16_t(2 * M_PI * r / 0.25f);
+    for (uint16_t i = 0; i <= segs; i++) {
+      const float a = 2 * M_PI * i / segs;
+      if (i) e += 2 * M_PI * r / segs * 0.033f;
+      sprintf(line, "G1 X%.3f Y%.3f E%.5f%s", 110 + r * cos(a), 110 + r * sin(a), e, i ? "" : " F6000");
+      run_line(line);
+    }
+  }
+}
+
+/**
+ * The same rings as arc-welded G2 quarter arcs, then a chain of
+ * small alternating G2/G3 arcs like welded curved infill.
+ */
+static void arc_welded() {
+  char line[64];
+  float e = 0;
+  for (uint8_t r = 20; r <= 60; r += 10) {
+    sprintf(line, "G0 X%u Y110 F6000", 110 + r);
+    run_line(line);
+    for (uint8_t q = 1; q <= 4; q++) {
+      const float a = q * M_PI / 2;
+      e += M_PI * r / 2 * 0.033f;
+      sprintf(line, "G2 X%.3f Y%.3f I%.3f J%.3f E%.5f", 110 + r * cos(a), 110 - r * sin(a), -r * cos(a - M_PI / 2), r * sin(a - M_PI / 2), e);
+      run_line(line);
+    }
+  }
+  run_line("G0 X30 Y20");
+  for (uint8_t i = 0; i < 40; i++) {
+    e += M_PI * 2 * 0.033f;
+    sprintf(line, "G%c X%u Y20 I2 J0 E%.5f", (i & 1) ? '3' : '2', 34 + i * 4, e);
+    run_line(line);
+  }
+}
+
+MARLIN_TEST(motion_bench, small_segments) {
+  bench_reset();
+  small_segments();
+  bench_report("small segments");
+  assert_in_position();
+  TEST_ASSERT_TRUE(bench.blocks > 1000);
+  TEST_ASSERT_TRUE(bench.events > 0);
+
+  // The same program must give the same step stream
+  const uint32_t checksum = bench.checksum;
+  bench_reset();
+  small_segments();
+  drain();
+  TEST_ASSERT_EQUAL_HEX32(checksum, bench.checksum);
+}
+
+#if ENABLED(ARC_SUPPORT)
+
+  MARLIN_TEST(motion_bench, arc_welded) {
+    bench_reset();
+    arc_welded();
+    bench_report("arc welded");
+    assert_in_position();
+    TEST_ASSERT_TRUE(bench.blocks > 100);
+  }
+
+#endif
+
+MARLIN_TEST(motion_bench, recorded_gcode) {
+  const char * const path = getenv("MOTION_BENCH_GCODE");
+  if (!path) TEST_IGNORE_MESSAGE("Set MOTION_BENCH_GCODE to a G-code file");
+  FILE *f = fopen(path, "r");
+  if (!f) TEST_FAIL_MESSAGE("Can't open MOTION_BENCH_GCODE");
+
+  bench_reset();
+  char line[256];
+  while (fgets(line, sizeof(line), f)) run_line(line);
+  fclose(f);
+  bench_report(path);
+  assert_in_position();
+}
+
+#endif // MOTION_BENCHMARK
@@ -0,0 +1,371 @@
+/**
+ * Marlin 3D Printer Firmware
+ * Copyright (c) 2024 MarlinFirmware [https://github.com/MarlinFirmware/Marlin]
+ *
+ * Based on Sprinter and grbl.
+ * Copyright (c) 2011 Camiel Gubbels / Erik van der Zalm
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ * Streaming binary uploads
+ *
+ * Uploads go to a simulated card: a RAM disk holding a FAT16 volume, put in
+ * place of the media driver. It tells single-block writes (FAT, directory)
+ * apart from the writeStart() / writeData() / writeStop() stream that the
+ * SDIO driver sends as CMD25, so the tests can check that the whole file
+ * went out in one multi-block write to a contiguous run of clusters.
+ *
+ * Serial output is collected by a thread, since the native serial port
+ * only buffers 128 bytes.
+ */
+
+#include "../test/unit_tests.h"
+
+#if ENABLED(BINARY_STREAM_UPLOAD)
+
+#include <src/sd/cardreader.h>
+#include <src/feature/binary_stream.h>
+
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class SimCard : public DiskIODriver {
+public:
+  static constexpr uint32_t total_blocks = 32768;
+  std::map<uint32_t, std::vector<uint8_t>> blocks;
+  uint32_t sessions, streamed, single, stream_first, stream_next;
+  bool streaming;
+
+  void reset() {
+    sessions = streamed = single = stream_first = stream_next = 0;
+    streaming = false;
+  }
+
+  /**
+   * FAT16 without a partition table: 4 blocks per cluster, 1 reserved block,
+   * two 32-block FATs and 512 root entries, so data starts at block 97.
+   */
+  void format() {
+    blocks.clear();
+    reset();
+    uint8_t b[512] = { 0xEB, 0x3C, 0x90 };
+    const auto put16 = [&b](const uint16_t o, const uint16_t v) { b[o] = v & 0xFF; b[o + 1] = v >> 8; };
+    put16(11, 512);           // bytesPerSector
+    b[13] = 4;                // sectorsPerCluster
+    put16(14, 1);             // reservedSectorCount
+    b[16] = 2;                // fatCount
+    put16(17, 512);           // rootDirEntryCount
+    put16(19, 0);             // totalSectors16 (use totalSectors32)
+    b[21] = 0xF8;             // mediaType
+    put16(22, 32);            // sectorsPerFat16
+    put16(32, total_blocks & 0xFFFF); put16(34, total_blocks >> 16);
+    put16(510, 0xAA55);
+    writeRaw(0, b);
+    memset(b, 0, sizeof(b));
+    put16(0, 0xFFF8); put16(2, 0xFFFF);
+    writeRaw(1, b);
+    writeRaw(33, b);
+  }
+
+  static uint32_t clusterBlock(const uint32_t cluster) { return 97 + (cluster - 2) * 4; }
+
+  uint16_t fatEntry(const uint32_t cluster) {
+    uint8_t b[512];
+    readBlock(1 + cluster / 256, b);
+    return b[(cluster % 256) * 2] | (b[(cluster % 256) * 2 + 1] << 8);
+  }
+
+  void writeRaw(const uint32_t block, const uint8_t * const src) { blocks[block].assign(src, src + 512); }
+
+  bool init(const uint8_t, const pin_t) override { return true; }
+  bool readCSD(csd_t * const) override { return false; }
+  bool readStart(const uint32_t) override { return false; }
+  bool readData(uint8_t * const) override { return false; }
+  bool readStop() override { return false; }
+
+  bool writeStart(const uint32_t block, const uint32_t) override {
+    if (streaming || block >= total_blocks) return false;
+    sessions++;
+    stream_first = stream_next = block;
+    return (streaming = true);
+  }
+  bool writeData(const uint8_t * const src) override {
+    if (!streaming || stream_next >= total_blocks) return false;
+    writeRaw(stream_next++, src);
+    streamed++;
+    return true;
+  }
+  bool writeStop() override { streaming = false; return true; }
+
+  bool readBlock(const uint32_t block, uint8_t * const dst) override {
+    if (streaming || block >= total_blocks) return false;
+    const auto it = blocks.find(block);
+    if (it == blocks.end()) memset(dst, 0, 512); else memcpy(dst, it->second.data(), 512);
+    return true;
+  }
+  bool writeBlock(const uint32_t block, const uint8_t * const src) override {
+    if (streaming || block >= total_blocks) return false;
+    single++;
+    writeRaw(block, src);
+    return true;
+  }
+
+  uint32_t cardSize() override { return total_blocks; }
+  bool isReady() override { return true; }
+  void idle() override {}
+};
+
+static SimCard sim;
+
+// Serial output, collected as it's sent
+static std::mutex output_lock;
+static std::string output_text;
+
+static void collect_output() {
+  for (;;) {
+    const int c = usb_serial.transmit_buffer.read();
+    if (c < 0) { std::this_thread::yield(); continue; }
+    std::lock_guard<std::mutex> lock(output_lock);
+    output_text += char(c);
+  }
+}
+
+// Take everything sent since the last call
+static std::string output() {
+  while (!usb_serial.transmit_buffer.empty()) std::this_thread::yield();
+  std::lock_guard<std::mutex> lock(output_lock);
+  std::string s;
+  s.swap(output_text);
+  return s;
+}
+
+static bool sent(const std::string &s, const char * const text) { return s.find(text) != std::string::npos; }
+
+static void sim_reset() {
+  static bool ready = false;
+  if (!ready) {
+    std::thread(collect_output).detach();
+    ready = true;
+  }
+  sim.format();
+  card.changeMedia(&sim);
+  output();
+}
+
+// Test data that doesn't repeat on block boundaries
+static std::vector<uint8_t> test_data(const uint32_t size) {
+  std::vector<uint8_t> d(size);
+  uint32_t x = 2463534242UL;
+  for (auto &v : d) { x ^= x << 13; x ^= x >> 17; x ^= x << 5; v = x & 0xFF; }
+  return d;
+}
+
+// Heatshrink's encoding of the data as literals only: a 1 tag bit and 8 data bits each
+static std::vector<uint8_t> literals(const std::vector<uint8_t> &d) {
+  std::vector<uint8_t> out;
+  uint32_t bits = 0;
+  uint8_t nbits = 0;
+  for (const uint8_t v : d) {
+    bits = (bits << 9) | 0x100 | v;
+    for (nbits += 9; nbits >= 8; nbits -= 8) out.push_back(bits >> (nbits - 8));
+  }
+  if (nbits) out.push_back(bits << (8 - nbits));
+  return out;
+}
+
+// Open (dummy, compression, name, size), as in file transfer protocol 0.2
+static std::vector<uint8_t> open_payload(const char * const name, const uint32_t size, const bool compress=false) {
+  std::vector<uint8_t> p = { 0, compress };
+  p.insert(p.end(), name, name + strlen(name) + 1);
+  for (uint8_t i = 0; i < 4; i++) p.push_back(size >> (i * 8));
+  return p;
+}
+
+enum : uint8_t { FT_OPEN = 1, FT_CLOSE, FT_WRITE };
+
+static void ft_process(const uint8_t type, std::vector<uint8_t> payload) {
+  SDFileTransferProtocol::process(type, (char*)payload.data(), payload.size());
+}
+
+// Send a whole transfer straight to the file transfer protocol in 'chunk' sized writes
+static std::string ft_upload(const char * const name, const std::vector<uint8_t> &wire, const uint32_t size, const bool compress=false, const size_t chunk=96) {
+  ft_process(FT_OPEN, open_payload(name, size, compress));
+  for (size_t i = 0; i < wire.size(); i += chunk)
+    ft_process(FT_WRITE, std::vector<uint8_t>(wire.begin() + i, wire.begin() + _MIN(i + chunk, wire.size())));
+  ft_process(FT_CLOSE, {});
+  return output();
+}
+
+// Mount the card again and compare the file with the data
+static void assert_file(const char * const name, const std::vector<uint8_t> &d) {
+  card.mount();
+  card.openFileRead(name);
+  TEST_ASSERT_TRUE(card.isFileOpen());
+  TEST_ASSERT_EQUAL_UINT32(d.size(), card.getFileSize());
+
+  // The data went out in one stream, to the file's own clusters
+  TEST_ASSERT_EQUAL_UINT32(1, sim.sessions);
+  TEST_ASSERT_EQUAL_UINT32((d.size() + 511) / 512, sim.streamed);
+  TEST_ASSERT_EQUAL_UINT32(SimCard::clusterBlock(card.getFileCluster()), sim.stream_first);
+
+  std::vector<uint8_t> back(d.size() + 1);
+  TEST_ASSERT_EQUAL_INT(d.size(), card.read(back.data(), back.size()));
+  back.pop_back();
+  TEST_ASSERT_TRUE(back == d);
+  card.closefile();
+  card.release();
+  output();
+}
+
+MARLIN_TEST(binary_upload, streams_to_preallocated_run) {
+  sim_reset();
+  const auto d = test_data(3000);
+  const std::string s = ft_upload("up.gco", d, d.size());
+  TEST_ASSERT_TRUE(sent(s, "PFT:success"));
+  TEST_ASSERT_TRUE(sent(s, "Upload 3000 bytes in "));
+  TEST_ASSERT_FALSE(sent(s, "PFT:ioerror"));
+
+  // Only the FAT and directory were written block by block
+  TEST_ASSERT_TRUE(sim.single < 16);
+  assert_file("up.gco", d);
+}
+
+MARLIN_TEST(binary_upload, compressed) {
+  sim_reset();
+  const auto d = test_data(5000), wire = literals(d);
+  const std::string s = ft_upload("zip.gco", wire, d.size(), true, 100);
+  TEST_ASSERT_TRUE(sent(s, "PFT:success"));
+  TEST_ASSERT_TRUE(sent(s, ("Upload 5000 bytes (" + std::to_string(wire.size()) + " sent)").c_str()));
+  assert_file("zip.gco", d);
+}
+
+MARLIN_TEST(binary_upload, size_overstated) {
+  sim_reset();
+  const auto d = test_data(1000);
+  const std::string s = ft_upload("short.gco", d, 4096);
+  TEST_ASSERT_TRUE(sent(s, "PFT:success"));
+  assert_file("short.gco", d);
+
+  // The file keeps one cluster and the second one reserved for it is free again
+  card.mount();
+  card.openFileRead("short.gco");
+  const uint32_t c = card.getFileCluster();
+  card.closefile();
+  card.release();
+  output();
+  TEST_ASSERT_TRUE(sim.fatEntry(c) >= 0xFFF8);
+  TEST_ASSERT_EQUAL_UINT16(0, sim.fatEntry(c + 1));
+}
+
+MARLIN_TEST(binary_upload, without_size) {
+  // A version 0.1 host doesn't send the size, so the file is written block by block
+  sim_reset();
+  const auto d = test_data(1500);
+  ft_process(FT_OPEN, open_payload("old.gco", 0));
+  ft_process(FT_WRITE, d);
+  ft_process(FT_CLOSE, {});
+  TEST_ASSERT_TRUE(sent(output(), "PFT:success"));
+  TEST_ASSERT_EQUAL_UINT32(0, sim.sessions);
+
+  card.mount();
+  card.openFileRead("old.gco");
+  TEST_ASSERT_EQUAL_UINT32(d.size(), card.getFileSize());
+  std::vector<uint8_t> back(d.size());
+  TEST_ASSERT_EQUAL_INT(d.size(), card.read(back.data(), back.size()));
+  TEST_ASSERT_TRUE(back == d);
+  card.closefile();
+  card.release();
+  output();
+}
+
+//
+// Windowed framing through the binary stream
+//
+
+static uint16_t fletcher16(uint16_t cs, const uint8_t v) {
+  const uint16_t lo = ((cs & 0xFF) + v) % 255;
+  return ((((cs >> 8) + lo) % 255) << 8) | lo;
+}
+
+static std::vector<uint8_t> build_packet(const uint8_t sync, const uint8_t protocol, const uint8_t type, const std::vector<uint8_t> &payload={}) {
+  std::vector<uint8_t> p = { 0xAD, 0xB5, sync, uint8_t((protocol << 4) | type), uint8_t(payload.size() & 0xFF), uint8_t(payload.size() >> 8) };
+  uint16_t cs = 0;
+  for (uint8_t i = 2; i < 6; i++) cs = fletcher16(cs, p[i]);
+  p.push_back(cs & 0xFF); p.push_back(cs >> 8);
+  cs = fletcher16(fletcher16(cs, p[6]), p[7]);
+  for (const uint8_t v : payload) { p.push_back(v); cs = fletcher16(cs, v); }
+  if (payload.size()) { p.push_back(cs & 0xFF); p.push_back(cs >> 8); }
+  return p;
+}
+
+// Feed bytes through the stream as fast as the 128 byte receive buffer takes them
+static std::string stream_send(const std::vector<uint8_t> &bytes) {
+  static char buffer[MAX_CMD_SIZE];
+  BinaryStream &bs = binaryStream[0];
+  for (size_t i = 0; i < bytes.size();) {
+    while (i < bytes.size() && usb_serial.receive_buffer.write(bytes[i])) i++;
+    bs.receive(buffer);
+  }
+  bs.receive(buffer);
+  return output();
+}
+
+MARLIN_TEST(binary_upload, windowed_stream) {
+  sim_reset();
+  BinaryStream &bs = binaryStream[0];
+  bs.reset();
+  bs.stream_state = BinaryStream::StreamState::PACKET_RESET;
+
+  // The sync reply carries the window and the larger packet size
+  std::string s = stream_send(build_packet(0, 0, 1));
+  TEST_ASSERT_TRUE(sent(s, "sw" STRINGIFY(BINARY_STREAM_WINDOW) "\n"));
+  TEST_ASSERT_TRUE(sent(s, "ss0," STRINGIFY(BINARY_STREAM_PACKET_SIZE) ",0.2.0\n"));
+
+  const auto d = test_data(4000);
+  std::vector<std::vector<uint8_t>> packets = { build_packet(0, 1, FT_OPEN, open_payload("win.gco", d.size())) };
+  for (size_t i = 0; i < d.size(); i += 400)
+    packets.push_back(build_packet(packets.size(), 1, FT_WRITE, std::vector<uint8_t>(d.begin() + i, d.begin() + _MIN(i + 400, d.size()))));
+
+  // A full window at a time, with one payload corrupted on its way
+  std::vector<uint8_t> bytes;
+  for (uint8_t i = 0; i < BINARY_STREAM_WINDOW; i++) {
+    auto p = packets[i];
+    if (i == 2) p[10] ^= 0x55;
+    bytes.insert(bytes.end(), p.begin(), p.end());
+  }
+  s = stream_send(bytes);
+  TEST_ASSERT_TRUE(sent(s, "ok0\n"));
+  TEST_ASSERT_TRUE(sent(s, "ok1\n"));
+  TEST_ASSERT_TRUE(sent(s, "rs2\n"));
+  TEST_ASSERT_FALSE(sent(s, "ok3\n"));
+
+  // Go back to the corrupt packet and send the rest in one go
+  bytes.clear();
+  for (size_t i = 2; i < packets.size(); i++) bytes.insert(bytes.end(), packets[i].begin(), packets[i].end());
+  s = stream_send(bytes);
+  TEST_ASSERT_TRUE(sent(s, ("ok" + std::to_string(packets.size() - 1) + "\n").c_str()));
+  TEST_ASSERT_FALSE(sent(s, "rs"));
+
+  s = stream_send(build_packet(packets.size(), 1, FT_CLOSE));
+  TEST_ASSERT_TRUE(sent(s, "PFT:success"));
+  TEST_ASSERT_TRUE(sent(s, "Upload 4000 bytes in "));
+  assert_file("win.gco", d);
+}
+
+#endif // BINARY_STREAM_UPLOAD
@@ -9,6 +9,15 @@ from PIL import Image
 
 RAW_BEGIN_TAG = "; E3V3SE_THUMB_RAW16_BEGIN"
 RAW_END_TAG   = "; E3V3SE_THUMB_RAW16_END"
+BIN_BEGIN_TAG = "; E3V3SE_THUMB_BIN_BEGIN"
+BIN_END_TAG   = "; E3V3SE_THUMB_BIN_END"
+HS_BEGIN_TAG  = "; E3V3SE_THUMB_HS_BEGIN"
+HS_END_TAG    = "; E3V3SE_THUMB_HS_END"
+
+# Must match HEATSHRINK_STATIC_WINDOW_BITS / _LOOKAHEAD_BITS in Marlin's heatshrink_config.h
+HS_WINDOW_BITS    = 8
+HS_LOOKAHEAD_BITS = 4
+HS_LINE_BYTES     = 57      # 76 base64 characters, no padding until the last line
 
 
 def rgb888_to_565(r, g, b):
@@ -65,11 +74,100 @@ def extract_thumbnail_b64(lines):
     return b64_string, width, height
 
 
-def build_raw16_block_from_b64(b64_string, width, height, force_size=(96, 96)):
+def crc16(data, crc=0):
+    """CRC-16 (poly 0x1021, MSB first) matching Marlin's crc16()."""
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def pack_row_565(pixels):
     """
-    Decodes the B64 (PNG/JPG), converts it to RGB565, and generates
-    the RAW16 block as a list of G-code lines (comments).
+    Pack one row of RGB565 values for E3V3SE_THUMB_BIN:
+      0x80 | (n - 1), color      n pixels of one color
+      0x00 | (n - 1), colors...  n literal colors
+    followed by the CRC-16 of the packet bytes. Colors are big-endian.
+
+    Row 40 of the sample image in Marlin/tests/lcd/test_dwin_thumb.cpp,
+    which the firmware test decodes from this exact text:
+
+    >>> row = [0x0400 + ((x // 3) << 5) + 10 if 24 <= x < 72 else 0x2104 for x in range(96)]
+    >>> base64.b64encode(pack_row_565(row)).decode("ascii")
+    'lyEEggUKggUqggVKggVqggWKggWqggXKggXqggYKggYqggZKggZqggaKggaqggbKggbqlyEE3To='
     """
+    out = bytearray()
+    literals = []
+
+    def flush_literals():
+        while literals:
+            chunk = literals[:128]
+            del literals[:128]
+            out.append(len(chunk) - 1)
+            for c in chunk:
+                out.extend(c.to_bytes(2, "big"))
+
+    i, w = 0, len(pixels)
+    while i < w:
+        run = 1
+        while i + run < w and run < 128 and pixels[i + run] == pixels[i]:
+            run += 1
+        if run >= 2:
+            flush_literals()
+            out.append(0x80 | (run - 1))
+            out += pixels[i].to_bytes(2, "big")
+        else:
+            literals.append(pixels[i])
+        i += run
+    flush_literals()
+
+    out += crc16(out).to_bytes(2, "big")
+    return bytes(out)
+
+
+def unpack_row_565(data, width):
+    """
+    Inverse of pack_row_565. Raises ValueError on a bad row.
+
+    >>> row = bytes([0x82, 0xF8, 0x00, 0x01, 0x12, 0x34, 0xAB, 0xCD])
+    >>> [hex(p) for p in unpack_row_565(row + crc16(row).to_bytes(2, "big"), 5)]
+    ['0xf800', '0xf800', '0xf800', '0x1234', '0xabcd']
+    >>> data = base64.b64decode("lyEEggUKggUqggVKggVqggWKggWqggXKggXqggYKggYqggZKggZqggaKggaqggbKggbqlyEE3To=")
+    >>> unpack_row_565(data, 96) == [0x0400 + ((x // 3) << 5) + 10 if 24 <= x < 72 else 0x2104 for x in range(96)]
+    True
+    >>> noise = [(x * 40503 + 7) & 0xFFFF for x in range(96)]
+    >>> unpack_row_565(pack_row_565(noise), 96) == noise
+    True
+    >>> unpack_row_565(data[:-1] + bytes([data[-1] ^ 1]), 96)
+    Traceback (most recent call last):
+    ValueError: bad CRC
+    >>> unpack_row_565(data, 95)
+    Traceback (most recent call last):
+    ValueError: bad row length
+    """
+    if len(data) < 3 or crc16(data[:-2]) != int.from_bytes(data[-2:], "big"):
+        raise ValueError("bad CRC")
+    pixels, i, end = [], 0, len(data) - 2
+    while i < end:
+        head = data[i]
+        count = (head & 0x7F) + 1
+        i += 1
+        if head & 0x80:
+            pixels += [int.from_bytes(data[i:i + 2], "big")] * count
+            i += 2
+        else:
+            for _ in range(count):
+                pixels.append(int.from_bytes(data[i:i + 2], "big"))
+                i += 2
+    if i != end or len(pixels) != width:
+        raise ValueError("bad row length")
+    return pixels
+
+
+def load_rgb565_rows(b64_string, force_size=(96, 96)):
+    """Decode the B64 (PNG/JPG) thumbnail into rows of RGB565 values."""
     img_bytes = base64.b64decode(b64_string)
     img = Image.open(io.BytesIO(img_bytes))
 
@@ -81,14 +179,121 @@ def build_raw16_block_from_b64(b64_string, width, height, force_size=(96, 96)):
     if img.size != (target_w, target_h):
         img = img.resize((target_w, target_h), Image.LANCZOS)
 
-    rows = []
-    for y in range(target_h):
-        hex_row = []
-        for x in range(target_w):
-            r, g, b = img.getpixel((x, y))
-            c565 = rgb888_to_565(r, g, b)
-            hex_row.append(f"{c565:04X}")
-        rows.append("".join(hex_row))
+    return [[rgb888_to_565(*img.getpixel((x, y))) for x in range(target_w)] for y in range(target_h)]
+
+
+def build_bin_block(rows_565):
+    """Generate the E3V3SE_THUMB_BIN block as a list of G-code lines (comments)."""
+    height, width = len(rows_565), len(rows_565[0])
+    block = [f"{BIN_BEGIN_TAG} {width}x{height}"]
+    for row in rows_565:
+        block.append("; " + base64.b64encode(pack_row_565(row)).decode("ascii"))
+    block.append(BIN_END_TAG)
+    return block
+
+
+def heatshrink_compress(data, window_bits=HS_WINDOW_BITS, lookahead_bits=HS_LOOKAHEAD_BITS):
+    """
+    Pure-Python heatshrink encoder (greedy LZSS) for Marlin's static decoder:
+      1, byte                              literal
+      0, offset - 1 (window bits), count - 1 (lookahead bits)   back-reference
+    Bits are packed MSB first and the final byte is zero-padded.
+    """
+    window, max_len = 1 << window_bits, 1 << lookahead_bits
+    out = bytearray()
+    acc = nbits = 0
+
+    def put(value, count):
+        nonlocal acc, nbits
+        acc = (acc << count) | value
+        nbits += count
+        while nbits >= 8:
+            nbits -= 8
+            out.append((acc >> nbits) & 0xFF)
+        acc &= (1 << nbits) - 1
+
+    pos, size = 0, len(data)
+    while pos < size:
+        lo = max(0, pos - window)
+        best_len = best_at = 0
+        # Grow the match while an earlier copy exists (it may overlap the current position)
+        length = 2
+        while length <= max_len and pos + length <= size:
+            at = data.rfind(data[pos:pos + length], lo, pos + length - 1)
+            if at < 0:
+                break
+            best_len, best_at = length, at
+            length += 1
+        if best_len >= 2:
+            put(0, 1)
+            put(pos - best_at - 1, window_bits)
+            put(best_len - 1, lookahead_bits)
+            pos += best_len
+        else:
+            put(1, 1)
+            put(data[pos], 8)
+            pos += 1
+
+    if nbits:
+        put(0, 8 - nbits)
+    return bytes(out)
+
+
+def heatshrink_decompress(data, window_bits=HS_WINDOW_BITS, lookahead_bits=HS_LOOKAHEAD_BITS):
+    """Reference decoder used to check heatshrink_compress()."""
+    out = bytearray()
+    bitpos, total = 0, len(data) * 8
+
+    def get(count):
+        nonlocal bitpos
+        if bitpos + count > total:
+            return None
+        value = 0
+        for _ in range(count):
+            value = (value << 1) | ((data[bitpos >> 3] >> (7 - (bitpos & 7))) & 1)
+            bitpos += 1
+        return value
+
+    while True:
+        tag = get(1)
+        if tag is None:
+            break
+        if tag:
+            byte = get(8)
+            if byte is None:
+                break
+            out.append(byte)
+        else:
+            index, count = get(window_bits), get(lookahead_bits)
+            if index is None or count is None:
+                break
+            for _ in range(count + 1):
+                out.append(out[-(index + 1)])
+    return bytes(out)
+
+
+def build_hs_block(rows_565):
+    """Generate the heatshrink-compressed E3V3SE_THUMB_HS block as G-code comment lines."""
+    height, width = len(rows_565), len(rows_565[0])
+    raw = b"".join(c.to_bytes(2, "big") for row in rows_565 for c in row)
+    packed = heatshrink_compress(raw)
+    if heatshrink_decompress(packed) != raw:
+        raise RuntimeError("heatshrink round trip failed")
+
+    block = [f"{HS_BEGIN_TAG} {width}x{height}"]
+    for i in range(0, len(packed), HS_LINE_BYTES):
+        block.append("; " + base64.b64encode(packed[i:i + HS_LINE_BYTES]).decode("ascii"))
+    block.append(HS_END_TAG)
+    return block
+
+
+def build_raw16_block_from_b64(b64_string, width, height, force_size=(96, 96)):
+    """
+    Decodes the B64 (PNG/JPG), converts it to RGB565, and generates
+    the RAW16 block as a list of G-code lines (comments).
+    """
+    target_w, target_h = force_size
+    rows = ["".join(f"{c565:04X}" for c565 in row) for row in load_rgb565_rows(b64_string, force_size)]
 
     block = []
     block.append(f"{RAW_BEGIN_TAG} {target_w}x{target_h}")
@@ -101,7 +306,7 @@ def build_raw16_block_from_b64(b64_string, width, height, force_size=(96, 96)):
 
 def insert_raw_block(lines, raw_block):
     """
-    Inserts the RAW16 block into the G-code.
+    Inserts the thumbnail block (RAW16, BIN or HS) into the G-code.
     Strategy:
       - If ; HEADER_BLOCK_END exists, insert right after it.
     """
@@ -156,17 +361,28 @@ def insert_m73_layer_numbers(lines, start_layer=1):
 
 
 def main():
-    if len(sys.argv) < 2:
-        print("Usage: python OrcaSlicer_E3V3SE_Thumb.py input.gcode [output.gcode]")
+    # --raw16 writes the older hex format for firmware without E3V3SE_THUMB_BIN support
+    # --heatshrink writes E3V3SE_THUMB_HS for firmware built with DWIN_THUMB_HEATSHRINK
+    # --test checks the encoders against the vectors in their docstrings
+    if "--test" in sys.argv[1:]:
+        import doctest
+        sys.exit(1 if doctest.testmod().failed else 0)
+
+    args = [a for a in sys.argv[1:] if not a.startswith("--")]
+    use_raw16 = "--raw16" in sys.argv[1:]
+    use_heatshrink = "--heatshrink" in sys.argv[1:]
+
+    if len(args) < 1:
+        print("Usage: python OrcaSlicer_E3V3SE_Thumb.py [--raw16 | --heatshrink] input.gcode [output.gcode]")
         sys.exit(1)
 
-    in_path = sys.argv[1]
+    in_path = args[0]
     if not os.path.isfile(in_path):
         print(f"File not found: {in_path}")
         sys.exit(1)
 
-    if len(sys.argv) >= 3:
-        out_path = sys.argv[2]
+    if len(args) >= 2:
+        out_path = args[1]
     else:
         out_path = in_path
 
@@ -177,10 +393,15 @@ def main():
     b64, w, h = extract_thumbnail_b64(lines)
     if b64:
         print(f"Thumbnail found: {w}x{h}")
-        raw_block = build_raw16_block_from_b64(b64, w, h, force_size=(96, 96))
+        if use_raw16:
+            raw_block = build_raw16_block_from_b64(b64, w, h, force_size=(96, 96))
+        elif use_heatshrink:
+            raw_block = build_hs_block(load_rgb565_rows(b64, force_size=(96, 96)))
+        else:
+            raw_block = build_bin_block(load_rgb565_rows(b64, force_size=(96, 96)))
         new_lines = insert_raw_block(lines, raw_block)
     else:
-        print("No thumbnail found in G-code. Skipping RAW16 insertion.")
+        print("No thumbnail found in G-code. Skipping thumbnail insertion.")
         new_lines = list(lines)
 
     # 2) Insert M73 L(n) after each ;LAYER_CHANGE
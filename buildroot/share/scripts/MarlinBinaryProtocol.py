@@ -55,6 +55,8 @@ class Protocol(object):
     packet_buffer = None
     simulate_errors = 0
     sync = 0
+    window = 1
+    in_flight = deque()
     connected = False
     syncronized = False
     worker_thread = None
@@ -74,7 +76,7 @@ class Protocol(object):
         self.connected = True
         self.response_timeout = timeout
 
-        self.register(['ok', 'rs', 'ss', 'fe'], self.process_input)
+        self.register(['ok', 'rs', 'ss', 'sw', 'fe'], self.process_input)
 
         self.worker_thread = threading.Thread(target=Protocol.receive_worker, args=(self,))
         self.worker_thread.start()
@@ -130,6 +132,7 @@ class Protocol(object):
         self.applications.append((tokens, callback))
 
     def send(self, protocol, packet_type, data = bytearray()):
+        self.flush()
         self.packet_transit = self.build_packet(protocol, packet_type, data)
         self.packet_status = 0
         self.transmit_attempt = 0
@@ -155,9 +158,66 @@ class Protocol(object):
 
         while len(self.responses):
             token, data = self.responses.popleft()
-            switch = {'ok' : self.response_ok, 'rs': self.response_resend, 'ss' : self.response_stream_sync, 'fe' : self.response_fatal_error}
+            switch = {'ok' : self.response_ok, 'rs': self.response_resend, 'ss' : self.response_stream_sync, 'sw' : self.response_window, 'fe' : self.response_fatal_error}
             switch[token](data)
 
+    # Send without waiting for the 'ok' while fewer than 'window' packets are unacknowledged
+    def queue(self, protocol, packet_type, data = bytearray()):
+        if self.window <= 1:
+            return self.send(protocol, packet_type, data)
+        packet = self.build_packet(protocol, packet_type, data, (self.sync + len(self.in_flight)) % 256)
+        self.in_flight.append(packet)
+        self.transmit_attempt = 0
+        self.transmit_packet(packet)
+        while len(self.in_flight) >= self.window:
+            self.await_window()
+
+    # Wait until every queued packet is acknowledged
+    def flush(self):
+        while len(self.in_flight):
+            self.await_window()
+
+    # An 'ok' acknowledges everything up to it. On 'rs' or a timeout go back and send the rest again.
+    def await_window(self):
+        timeout = TimeOut(self.response_timeout * 20)
+        while True:
+            try:
+                self.await_response_window()
+                return
+            except ReadTimeout:
+                if timeout.timedout():
+                    raise ConnectionLost()
+                self.errors += 1
+                for packet in self.in_flight:
+                    self.transmit_packet(packet)
+
+    def await_response_window(self):
+        timeout = TimeOut(self.response_timeout)
+        while not len(self.responses):
+            time.sleep(0.00001)
+            if timeout.timedout():
+                raise ReadTimeout()
+
+        while len(self.responses):
+            token, data = self.responses.popleft()
+            if token == 'ok':
+                try:
+                    acked = (int(data) - self.sync) % 256
+                except ValueError:
+                    continue
+                if acked < len(self.in_flight):
+                    for i in range(acked + 1):
+                        self.in_flight.popleft()
+                    self.sync = (self.sync + acked + 1) % 256
+            elif token == 'rs':
+                self.errors += 1
+                if int(data) != self.sync:
+                    raise SynchronizationError()
+                for packet in self.in_flight:
+                    self.transmit_packet(packet)
+            elif token == 'fe':
+                self.response_fatal_error(data)
+
     def send_ascii(self, data, send_and_forget = False):
         self.packet_transit = bytearray(data, "utf8") + b'\n'
         self.packet_status = 0
@@ -210,7 +270,7 @@ class Protocol(object):
         self.port.write(packet)
         self.transmit_attempt += 1
 
-    def build_packet(self, protocol, packet_type, data = bytearray()):
+    def build_packet(self, protocol, packet_type, data = bytearray(), sync = None):
         PACKET_TOKEN = 0xB5AD
 
         if len(data) > self.max_block_size:
@@ -218,7 +278,7 @@ class Protocol(object):
 
         packet_buffer = bytearray()
 
-        packet_buffer += self.pack_int8(self.sync)                           # 8bit sync id
+        packet_buffer += self.pack_int8(self.sync if sync is None else sync) # 8bit sync id
         packet_buffer += self.pack_int4_2(protocol, packet_type)             # 4 bit protocol id, 4 bit packet type
         packet_buffer += self.pack_int16(len(data))                          # 16bit packet length
         packet_buffer += self.pack_int16(self.build_checksum(packet_buffer)) # 16bit header checksum
@@ -289,7 +349,11 @@ class Protocol(object):
         self.protocol_version = protocol_version
         self.packet_status = 1
         self.syncronized = True
-        print("Connection synced [{0}], binary protocol version {1}, {2} byte payload buffer".format(self.sync, self.protocol_version, self.max_block_size))
+        print("Connection synced [{0}], binary protocol version {1}, {2} byte payload buffer, window {3}".format(self.sync, self.protocol_version, self.max_block_size, self.window))
+
+    # Sent before 'ss' by firmware with BINARY_STREAM_UPLOAD
+    def response_window(self, data):
+        self.window = max(int(data), 1)
 
     def response_fatal_error(self, data):
         raise FatalError()
@@ -340,10 +404,12 @@ class FileTransferProtocol(object):
 
         print("File Transfer version: {0}, compression: {1}".format(self.version, self.compression['algorithm']))
 
-    def open(self, filename, compression, dummy):
+    def open(self, filename, compression, dummy, size = 0):
         payload =  b'\1' if dummy else b'\0'          # dummy transfer
         payload += b'\1' if compression else b'\0'    # payload compression
         payload += bytearray(filename, 'utf8') + b'\0'# target filename + null terminator
+        if size and tuple(int(v) for v in self.version.split('.')[:2]) >= (0, 2):
+            payload += self.protocol.pack_int32(size)  # file size, to stream into pre-allocated space
 
         timeout = TimeOut(5000)
         token = None
@@ -367,7 +433,7 @@ class FileTransferProtocol(object):
         raise ReadTimeout()
 
     def write(self, data):
-        self.protocol.send(FileTransferProtocol.protocol_id, FileTransferProtocol.Packet.WRITE, data)
+        self.protocol.queue(FileTransferProtocol.protocol_id, FileTransferProtocol.Packet.WRITE, data)
 
     def close(self):
         self.protocol.send(FileTransferProtocol.protocol_id, FileTransferProtocol.Packet.CLOSE)
@@ -400,7 +466,7 @@ class FileTransferProtocol(object):
         data = open(filename, "rb").read()
         filesize = len(data)
 
-        self.open(dest_filename, compression, dummy)
+        self.open(dest_filename, compression, dummy, filesize)
 
         block_size = self.protocol.block_size
         if compression: